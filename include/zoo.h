@@ -29,6 +29,7 @@
 #define __ZOO_H__
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include "zoo_config.h"
 
@@ -50,6 +51,14 @@ typedef struct s_zoo_video_driver {
 	void (*func_read)(struct s_zoo_video_driver *drv, int16_t x, int16_t y, uint8_t *col, uint8_t *chr);
 	void *(*func_store_display)(struct s_zoo_video_driver *drv, int16_t x, int16_t y, int16_t width, int16_t height);
 	void (*func_restore_display)(struct s_zoo_video_driver *drv, void *data, int16_t width, int16_t height, int16_t srcx, int16_t srcy, int16_t srcwidth, int16_t srcheight, int16_t dstx, int16_t dsty);
+
+#ifdef ZOO_USE_VIDEO_BATCH
+	// optional batch interface; if either is implemented, board cells are
+	// collected in zoo_state and sent once per flush (see zoo_video_flush)
+	// data is (col, chr) pairs, pitch is the distance between rows in bytes
+	void (*func_write_span)(struct s_zoo_video_driver *drv, int16_t x, int16_t y, int16_t width, const uint8_t *data);
+	void (*func_write_rect)(struct s_zoo_video_driver *drv, int16_t x, int16_t y, int16_t width, int16_t height, const uint8_t *data, int16_t pitch);
+#endif
 } zoo_video_driver;
 
 // PIT timing
@@ -127,6 +136,9 @@ typedef struct {
 	zoo_call *call;
  	uint8_t state;
 	zoo_call *curr_call;
+#ifdef ZOO_METRICS
+	uint32_t metrics_pushes; // libzoo addition: folded into zoo_metrics
+#endif
 } zoo_call_stack;
 
 #define zoo_call_empty(stack) ((stack)->call == NULL)
@@ -168,6 +180,9 @@ typedef struct s_zoo_sound_state {
 	int16_t buffer_pos;
 	int16_t buffer_len;
 	bool is_playing;
+#ifdef ZOO_METRICS
+	uint32_t metrics_notes; // libzoo addition: folded into zoo_metrics
+#endif
 
 	zoo_sound_driver *d_sound;
 } zoo_sound_state;
@@ -188,10 +203,17 @@ typedef enum {
 	MODE_WRITE
 } zoo_io_mode;
 
+typedef void (*zoo_func_io_release)(void *arg);
+
 typedef struct s_zoo_io_handle {
 	void *p;
 	int len;
-	int len_orig;
+	// buffer window: while buf_pos is below buf_read_end (buf_write_end),
+	// callers may read (write) bytes there directly instead of calling
+	// func_getc (func_putc); the handle's functions must account for this
+	uint8_t *buf_pos;
+	uint8_t *buf_read_end;
+	uint8_t *buf_write_end;
 	uint8_t *(*func_getptr)(struct s_zoo_io_handle *h);
 	uint8_t (*func_getc)(struct s_zoo_io_handle *h);
 	size_t (*func_read)(struct s_zoo_io_handle *h, uint8_t *ptr, size_t len);
@@ -200,6 +222,10 @@ typedef struct s_zoo_io_handle {
 	size_t (*func_skip)(struct s_zoo_io_handle *h, size_t len);
 	size_t (*func_tell)(struct s_zoo_io_handle *h);
 	void (*func_close)(struct s_zoo_io_handle *h);
+	// optional (ZOO_USE_ROM_POINTERS): keeps the data behind func_getptr
+	// valid after the handle is closed, until the returned function is
+	// called with *arg
+	zoo_func_io_release (*func_retain)(struct s_zoo_io_handle *h, void **arg);
 } zoo_io_handle;
 
 typedef struct s_zoo_io_driver {
@@ -210,6 +236,8 @@ typedef struct s_zoo_io_driver {
 } zoo_io_driver;
 
 #define zoo_io_open_file_empty() zoo_io_open_file_mem(NULL, 0, MODE_READ)
+// true for the empty handle drivers return if a file could not be opened
+#define zoo_io_file_is_empty(h) ((h)->p == NULL)
 zoo_io_handle zoo_io_open_file_mem(uint8_t *ptr, size_t len, zoo_io_mode mode);
 
 // game
@@ -218,6 +246,7 @@ zoo_io_handle zoo_io_open_file_mem(uint8_t *ptr, size_t len, zoo_io_mode mode);
 
 #define ZOO_BOARD_WIDTH 60
 #define ZOO_BOARD_HEIGHT 25
+#define ZOO_BOARD_ROW_WORDS ((ZOO_BOARD_WIDTH + 31) >> 5)
 #define ZOO_MAX_STAT 150
 #define ZOO_MAX_BOARD 100
 #define ZOO_MAX_ELEMENT 53
@@ -231,6 +260,15 @@ zoo_io_handle zoo_io_open_file_mem(uint8_t *ptr, size_t len, zoo_io_mode mode);
 #define ZOO_TORCH_DY 5
 #define ZOO_TORCH_DSQ 50
 
+// stat scheduler: cycles 1..ZOO_STAT_SCHED_CYCLES get per-phase bitmaps,
+// other cycles are tested individually
+#define ZOO_STAT_SCHED_CYCLES 8
+#define ZOO_STAT_SCHED_BUCKETS (ZOO_STAT_SCHED_CYCLES * (ZOO_STAT_SCHED_CYCLES + 1) / 2)
+#define ZOO_STAT_SCHED_WORDS ((ZOO_MAX_STAT + 2 + 31) / 32)
+
+// object name index: hash buckets (power of two)
+#define ZOO_NAME_INDEX_BUCKETS 32
+
 typedef struct {
 	uint8_t element;
 	uint8_t color;
@@ -240,6 +278,9 @@ typedef struct {
 typedef struct {
 	int16_t pos;
 	bool zapped;
+	uint8_t len; // of the label name
+	uint16_t hash; // of the label name, upper case
+	int16_t next; // next label in the same hash bucket, or -1
 } zoo_stat_label;
 #endif
 
@@ -253,6 +294,8 @@ typedef struct {
 	char *data;
 	int16_t data_pos;
 	int16_t data_len;
+	// fields above are saved with the board (ZOO_STAT_SAVED_SIZE)
+	uint16_t oop_limit_hits; // libzoo addition: ticks cut short by oop_ins_limit
 
 #ifdef ZOO_USE_LABEL_CACHE
 	zoo_stat_label *label_cache;
@@ -263,6 +306,8 @@ typedef struct {
 #endif
 } zoo_stat;
 
+#define ZOO_STAT_SAVED_SIZE offsetof(zoo_stat, oop_limit_hits)
+
 typedef struct {
 	uint8_t count;
 	zoo_tile tile;
@@ -297,18 +342,75 @@ typedef struct {
 
 typedef struct {
 	char name[51];
-	zoo_tile tiles[ZOO_BOARD_WIDTH + 2][ZOO_BOARD_HEIGHT + 2];
+	// libzoo addition: row-major, so that board-wide passes walk memory
+	// in order; access through ZOO_TILE
+	zoo_tile tiles[ZOO_BOARD_HEIGHT + 2][ZOO_BOARD_WIDTH + 2];
 	int16_t stat_count;
 	zoo_stat stats[ZOO_MAX_STAT + 2];
 	zoo_board_info info;
+
+#ifdef ZOO_USE_STAT_INDEX
+	// libzoo addition: per-tile stat lookup (zoo_stat_get_id), kept up to date
+	// by zoo_stat_add/remove/move; stores lowest stat ID + 1 (0 = none).
+	// Row-major like tiles.
+	uint8_t stat_index[ZOO_BOARD_HEIGHT + 2][ZOO_BOARD_WIDTH + 2];
+	uint8_t stat_index_count[ZOO_BOARD_HEIGHT + 2][ZOO_BOARD_WIDTH + 2];
+#endif
+
+	// libzoo addition: stat scheduler bitmaps, indexed by stat ID; the due
+	// bitmap is cached for stat_sched_tick (-1 = stale)
+	uint32_t stat_sched[ZOO_STAT_SCHED_BUCKETS][ZOO_STAT_SCHED_WORDS];
+	uint32_t stat_sched_other[ZOO_STAT_SCHED_WORDS];
+	uint32_t stat_sched_due[ZOO_STAT_SCHED_WORDS];
+	int16_t stat_sched_tick;
+
+	// libzoo addition: hash of each stat's @name (0 = none), and stat IDs
+	// chained by hash bucket in ascending order, for zoo_oop_iterate_stat;
+	// rebuilt on demand once flagged stale. Code changing stats or their
+	// code other than through libzoo functions must clear name_hash_valid.
+	uint16_t name_hash[ZOO_MAX_STAT + 2];
+	int16_t name_next[ZOO_MAX_STAT + 2];
+	int16_t name_head[ZOO_NAME_INDEX_BUCKETS];
+	bool name_hash_valid, name_chain_valid;
+
+#ifdef ZOO_USE_ELEMENT_INDEX
+	// libzoo addition: positions of each element on the playfield, one bit
+	// per tile (bit x - 1 of row y - 1), plus a mask of non-empty rows;
+	// kept up to date by zoo_board_set_element/zoo_board_set_tile
+	uint32_t element_index[ZOO_MAX_ELEMENT + 1][ZOO_BOARD_HEIGHT][ZOO_BOARD_ROW_WORDS];
+	uint32_t element_index_rows[ZOO_MAX_ELEMENT + 1];
+#endif
+
+#ifdef ZOO_USE_BOARD_SNAPSHOT
+	// libzoo addition: set when tiles or object code change after
+	// zoo_board_open. Element code writes stat fields directly, so stats and
+	// board info are instead compared against copies taken on open. A board
+	// with no changes keeps its existing board_data on zoo_board_close.
+	// Code modifying tiles or object code other than through libzoo
+	// functions must set dirty.
+	bool dirty;
+	int16_t saved_stat_count;
+	zoo_board_info saved_info;
+	uint8_t saved_stats[ZOO_MAX_STAT + 2][ZOO_STAT_SAVED_SIZE];
+#endif
+#ifdef ZOO_METRICS
+	uint32_t metrics_mallocs; // libzoo addition: folded into zoo_metrics
+#endif
 } zoo_board;
 
+#define ZOO_TILE(board, x, y) ((board)->tiles[(y)][(x)])
+
 typedef struct {
 	int16_t board_count;
 	void *board_data[ZOO_MAX_BOARD + 2];
 	int16_t board_len[ZOO_MAX_BOARD + 2];
 	bool board_external[ZOO_MAX_BOARD + 2];
 	zoo_world_info info;
+#ifdef ZOO_USE_ROM_POINTERS
+	// set if board data points into the data of the handle it was read from
+	zoo_func_io_release rom_release;
+	void *rom_release_arg;
+#endif
 } zoo_world;
 
 typedef struct {
@@ -382,6 +484,23 @@ typedef enum {
 	GS_PLAY
 } zoo_game_state;
 
+#ifdef ZOO_METRICS
+// libzoo addition: engine work done over one game cycle, see func_metrics.
+// Counting costs nothing only when ZOO_METRICS is left out of the build;
+// with it, the counts are kept whether or not a hook is installed.
+typedef struct {
+	uint32_t stats_ticked;
+	uint32_t oop_instructions;
+	uint32_t video_writes; // cells written through zoo_video_write or board drawing
+	uint32_t board_opens;
+	uint32_t board_closes;
+	uint32_t board_bytes_encoded;
+	uint32_t sound_notes_queued;
+	uint32_t call_pushes;
+	uint32_t mallocs; // call stack, stat code, label and OOP caches, boards, display copies, text windows
+} zoo_metrics;
+#endif
+
 typedef struct s_zoo_state {
 	zoo_board board;
 	zoo_world world;
@@ -400,6 +519,7 @@ typedef struct s_zoo_state {
 	int16_t tick_speed;
 	int16_t tick_duration;
 	zoo_time_ms time_elapsed;
+	uint32_t cycle_count; // game cycles (incl. paused ones) run so far
 	bool game_paused;
 	bool game_paused_blink;
 	bool force_darkness_off;
@@ -408,6 +528,19 @@ typedef struct s_zoo_state {
 	char oop_word[21];
 	int16_t oop_value;
 
+	// libzoo addition: OOP instruction limits. oop_ins_limit caps the
+	// commands one object runs per tick (32 in ZZT). With oop_frame_budget
+	// set, once objects have run that many commands, the rest of the game
+	// cycle is left for the next frame (RETURN_NEXT_FRAME).
+	int16_t oop_ins_limit;
+	uint16_t oop_frame_budget; // 0 = never yield
+	uint16_t oop_frame_ins;
+	uint32_t oop_limit_hits; // ticks cut short by oop_ins_limit, all objects
+	uint32_t oop_frame_yields;
+#ifdef ZOO_USE_OOP_CACHE
+	void *oop_word_entry; // libzoo addition: cache entry oop_word was read from, until the next read
+#endif
+
 	zoo_input_state input;
 	zoo_sound_state sound;
 
@@ -415,6 +548,7 @@ typedef struct s_zoo_state {
 	zoo_tile object_replace_tile;
 	zoo_text_window object_window;
 	bool object_window_request;
+	int16_t window_x, window_y, window_width, window_height;
 	zoo_call_stack call_stack;
 	uint8_t game_tick_state; // not in call_stack to save performance
 
@@ -427,9 +561,36 @@ typedef struct s_zoo_state {
 	zoo_video_driver *d_video;
 	zoo_io_driver *d_io;
 
+#ifdef ZOO_USE_VIDEO_BATCH
+	// board area cells pending a batched video flush
+	uint8_t video_buffer[ZOO_BOARD_HEIGHT][ZOO_BOARD_WIDTH * 2];
+	uint32_t video_dirty[ZOO_BOARD_HEIGHT][ZOO_BOARD_ROW_WORDS];
+	uint32_t video_dirty_rows;
+#endif
+
+	// recently closed boards kept decoded (see zoo_board_cache_set_limit)
+	struct s_zoo_board_cache_entry *board_cache_head; // most recently used
+	struct s_zoo_board_cache_entry *board_cache_tail;
+	size_t board_cache_size;
+	size_t board_cache_limit; // in bytes, 0 = disabled
+
+#ifdef ZOO_METRICS
+	zoo_metrics metrics; // counts for the current game cycle
+#endif
+
+#ifdef ZOO_PROFILE
+	struct s_zoo_profile *profile; // NULL unless enabled (zoo_profile_enable)
+#endif
+
 	// - high-level engine hooks (optional, have default implementations)
 	void (*func_draw_sidebar)(struct s_zoo_state *state, uint16_t flags);
 	void (*func_write_message)(struct s_zoo_state *state, uint8_t p2, const char *message);
+#ifdef ZOO_METRICS
+	// - metrics hook (optional): called at the end of every game cycle;
+	//   the counts are cleared after every cycle either way, but only
+	//   gathered up from the call stack, sound and board with a hook
+	void (*func_metrics)(struct s_zoo_state *state, const zoo_metrics *metrics);
+#endif
 } zoo_state;
 
 typedef struct {
@@ -467,6 +628,12 @@ typedef struct {
 
 // zoo.c
 
+// Thread safety: libzoo keeps all mutable engine state in zoo_state (and the
+// structures it points to), so independent zoo_state instances may be ticked
+// from different threads at the same time. A single zoo_state, and any drivers
+// or buffers it shares with another, must only be used by one thread at a time.
+// File-scope data in libzoo (element definitions, token tables, the default
+// video driver) is read-only.
 void zoo_state_init(zoo_state *state);
 void zoo_redraw(zoo_state *state);
 int zoo_world_reload(zoo_state *state);
@@ -475,6 +642,12 @@ int zoo_world_return_title(zoo_state *state);
 
 void* zoo_store_display(zoo_state *state, int16_t x, int16_t y, int16_t width, int16_t height);
 void zoo_restore_display(zoo_state *state, void *data, int16_t width, int16_t height, int16_t srcx, int16_t srcy, int16_t srcwidth, int16_t srcheight, int16_t dstx, int16_t dsty);
+void zoo_video_write(zoo_state *state, int16_t x, int16_t y, uint8_t col, uint8_t chr);
+#ifdef ZOO_USE_VIDEO_BATCH
+void zoo_video_flush(zoo_state *state);
+#else
+#define zoo_video_flush(state)
+#endif
 void zoo_free_display(zoo_state *state, void *data);
 
 bool zoo_check_hsecs_elapsed(zoo_state *state, int16_t *hsecs_counter, int16_t hsecs_value);
@@ -504,8 +677,10 @@ void zoo_board_draw(zoo_state *state);
 void zoo_stat_add(zoo_state *state, int16_t tx, int16_t ty, uint8_t element, int16_t color, int16_t tcycle, const zoo_stat *stat_template);
 void zoo_stat_remove(zoo_state *state, int16_t stat_id);
 int16_t zoo_stat_get_id(zoo_state *state, int16_t x, int16_t y);
+void zoo_stat_index_build(zoo_board *board);
 zoo_stat *zoo_stat_get(zoo_state *state, int16_t x, int16_t y, int16_t *stat_id);
 void zoo_stat_move(zoo_state *state, int16_t stat_id, int16_t new_x, int16_t new_y);
+void zoo_stat_set_cycle(zoo_state *state, int16_t stat_id, int16_t cycle);
 
 void zoo_board_damage_stat(zoo_state *state, int16_t stat_id);
 void zoo_board_damage_tile(zoo_state *state, int16_t x, int16_t y);
@@ -527,6 +702,14 @@ void zoo_game_stop(zoo_state *state);
 
 void zoo_tick_advance_pit(zoo_state *state);
 zoo_tick_retval zoo_tick(zoo_state *state);
+// Like zoo_tick, but steps through stats until the cycle completes, something
+// is pushed onto the call stack, or budget stats (0 = no limit) have run.
+zoo_tick_retval zoo_tick_cycle(zoo_state *state, uint16_t budget);
+// Runs up to n game cycles as fast as possible on a virtual clock, advancing
+// the PIT, sound and input state itself instead of waiting for the frontend.
+// Stops early on error or when the call stack is waiting (for example, on an
+// open window); returns the number of cycles run.
+uint32_t zoo_run_ticks(zoo_state *state, uint32_t n);
 
 // zoo_game_io.c
 
@@ -544,6 +727,12 @@ int zoo_io_world_write(zoo_io_handle *h, zoo_world *world);
 int zoo_board_close(zoo_state *state);
 int zoo_board_open(zoo_state *state, int16_t board_id);
 
+// Keeps up to limit bytes of recently closed boards in decoded form, so that
+// reopening one skips decoding it from board_data. 0 (the default) disables
+// the cache; board_data is written on close either way.
+void zoo_board_cache_set_limit(zoo_state *state, size_t limit);
+void zoo_board_cache_clear(zoo_state *state);
+
 int zoo_world_close(zoo_state *state);
 int zoo_world_load(zoo_state *state, zoo_io_handle *h, bool title_only);
 int zoo_world_save(zoo_state *state, zoo_io_handle *h);
@@ -564,6 +753,8 @@ void zoo_input_action_set(zoo_input_state *state, zoo_input_action action, bool
 
 void zoo_stat_clear(zoo_stat *stat);
 void zoo_stat_free(zoo_stat *stat);
+// allocates len bytes of object code for stat->data
+char *zoo_stat_data_alloc(int16_t len);
 
 int16_t zoo_flag_get_id(zoo_state *state, const char *name);
 void zoo_flag_set(zoo_state *state, const char *name);
@@ -572,6 +763,42 @@ void zoo_flag_clear(zoo_state *state, const char *name);
 bool zoo_oop_send(zoo_state *state, int16_t stat_id, const char *send_label, bool ignore_lock);
 void zoo_oop_execute(zoo_state *state, int16_t stat_id, int16_t *position, const char *default_name);
 
+#ifdef ZOO_PROFILE
+// zoo_profile.c
+
+typedef struct {
+	uint32_t calls;
+	uint64_t time;
+} zoo_profile_counter;
+
+typedef enum {
+	ZOO_PROFILE_JSON,
+	ZOO_PROFILE_CSV
+} zoo_profile_format;
+
+typedef struct s_zoo_profile {
+	// time source, counting up in time_unit (which is only used for output)
+	uint32_t (*func_time)(void);
+	const char *time_unit;
+
+	// tick_func, touch_func and draw_func calls made by libzoo, by element
+	zoo_profile_counter element_tick[ZOO_MAX_ELEMENT + 1];
+	zoo_profile_counter element_touch[ZOO_MAX_ELEMENT + 1];
+	zoo_profile_counter element_draw[ZOO_MAX_ELEMENT + 1];
+	// tick_func calls by stat ID; reset when the board changes
+	zoo_profile_counter stat_tick[ZOO_MAX_STAT + 2];
+	int16_t stat_board;
+	// OOP commands run, by instruction token (TOK_INS_INVALID: #label)
+	uint32_t oop_commands[256];
+} zoo_profile;
+
+// func_time may be NULL, to use clock()
+bool zoo_profile_enable(zoo_state *state, uint32_t (*func_time)(void), const char *time_unit);
+void zoo_profile_disable(zoo_state *state);
+void zoo_profile_reset(zoo_state *state);
+int zoo_profile_write(zoo_state *state, zoo_io_handle *h, zoo_profile_format format);
+#endif
+
 // zoo_window.c
 
 char *zoo_window_line_at(zoo_text_window *window, int pos);
@@ -585,7 +812,7 @@ bool zoo_window_open_file(zoo_io_driver *io, zoo_text_window *window, const char
 // zoo_window_classic.c
 
 void zoo_window_open(zoo_state *state, zoo_text_window *window);
-void zoo_window_set_position(int16_t x, int16_t y, int16_t width, int16_t height);
+void zoo_window_set_position(zoo_state *state, int16_t x, int16_t y, int16_t width, int16_t height);
 
 // zoo_ui_*
 
@@ -33,8 +33,13 @@
 #ifndef ZOO_USE_LABEL_CACHE
 #error Label cache required for ROM pointer support!
 #endif
-#define ZOO_STORE_LABEL_CACHE
 #define ZOO_NO_OBJECT_CODE_WRITES
 #endif
 
+#ifdef ZOO_USE_LABEL_CACHE
+// Label caches are kept in the packed board format, so that they are built
+// once per world load rather than after every board change.
+#define ZOO_STORE_LABEL_CACHE
+#endif
+
 #endif /* __ZOO_CONFIG_H__ */
@@ -0,0 +1,41 @@
+/**
+ * Copyright (c) 2020 Adrian Siekierka
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __ZOO_IO_MMAP_H__
+#define __ZOO_IO_MMAP_H__
+
+#include <stddef.h>
+#include "zoo_io_path.h"
+
+// A POSIX driver which memory-maps files opened for reading. Board data and
+// object code point straight into the mapping (see ZOO_USE_ROM_POINTERS);
+// this driver provides platform_is_rom_ptr() for that purpose.
+typedef struct {
+	zoo_io_path_driver parent;
+	struct s_zoo_io_mmap_file *files;
+} zoo_io_mmap_driver;
+
+void zoo_io_create_mmap_driver(zoo_io_mmap_driver *drv);
+// Unmaps all files; close any world loaded through the driver first.
+void zoo_io_free_mmap_driver(zoo_io_mmap_driver *drv);
+
+#endif /* __ZOO_IO_MMAP_H__ */
\ No newline at end of file
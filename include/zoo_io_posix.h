@@ -26,6 +26,10 @@
 #include <stddef.h>
 #include "zoo_io_path.h"
 
+zoo_io_handle zoo_io_open_file_posix(zoo_io_path_driver *drv, const char *name, zoo_io_mode mode);
+// Opens a temporary file next to name for writing, which is renamed over
+// name once the handle is closed; until then, name is left untouched.
+zoo_io_handle zoo_io_open_file_posix_replace(zoo_io_path_driver *drv, const char *name);
 void zoo_io_create_posix_driver(zoo_io_path_driver *drv);
 
 #endif /* __ZOO_IO_POSIX_H__ */
\ No newline at end of file
@@ -0,0 +1,306 @@
+/**
+ * Copyright (c) 2020 Adrian Siekierka
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../libzoo/zoo_internal.h"
+#include "zoo_io_mmap.h"
+#include "zoo_io_posix.h"
+
+#ifndef ZOO_USE_ROM_POINTERS
+#error The mmap I/O driver requires ZOO_USE_ROM_POINTERS!
+#endif
+
+// Files opened for reading are mapped read-only into one address range which
+// is reserved for the whole process, so that platform_is_rom_ptr() is a
+// range check. Each mapping takes one extra page in front of the file, which
+// holds its zoo_io_mmap_file.
+//
+// Mappings belong to the driver which made them. Open handles and loaded
+// worlds (func_retain) hold references to them; the last one to go unmaps
+// the file. Reopening an unchanged file reuses its mapping. Like a
+// zoo_state, a driver must only be used by one thread at a time - only the
+// reserved range is shared, and its allocator takes a lock.
+
+#ifndef ZOO_IO_MMAP_RANGE_SIZE
+#if UINTPTR_MAX > 0xFFFFFFFF
+#define ZOO_IO_MMAP_RANGE_SIZE ((size_t) 1 << 32)
+#else
+#define ZOO_IO_MMAP_RANGE_SIZE ((size_t) 1 << 28)
+#endif
+#endif
+
+struct s_zoo_io_mmap_file {
+	struct s_zoo_io_mmap_file *next;
+	zoo_io_mmap_driver *drv;
+	int refs;
+	dev_t dev;
+	ino_t ino;
+	off_t size;
+	struct timespec mtime;
+	size_t range_len; // including the leading page
+	uint8_t *ptr;
+};
+
+typedef struct s_zoo_io_mmap_file zoo_io_mmap_file;
+
+// free parts of the reserved range, sorted by offset
+
+typedef struct s_zoo_io_mmap_extent {
+	struct s_zoo_io_mmap_extent *next;
+	size_t offset;
+	size_t len;
+} zoo_io_mmap_extent;
+
+static pthread_once_t zoo_io_mmap_range_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t zoo_io_mmap_range_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint8_t *zoo_io_mmap_range;
+static size_t zoo_io_mmap_range_size;
+static size_t zoo_io_mmap_page_size;
+static zoo_io_mmap_extent *zoo_io_mmap_free;
+
+bool platform_is_rom_ptr(void *ptr) {
+	uint8_t *range = __atomic_load_n(&zoo_io_mmap_range, __ATOMIC_RELAXED);
+	size_t size = __atomic_load_n(&zoo_io_mmap_range_size, __ATOMIC_RELAXED);
+
+	return ((uintptr_t) ptr - (uintptr_t) range) < size;
+}
+
+static void zoo_io_mmap_range_init(void) {
+	zoo_io_mmap_extent *extent;
+	void *ptr;
+
+	extent = malloc(sizeof(zoo_io_mmap_extent));
+	if (extent == NULL)
+		return;
+
+	// reserve address space only; files are mapped over parts of it
+	ptr = mmap(NULL, ZOO_IO_MMAP_RANGE_SIZE, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (ptr == MAP_FAILED) {
+		free(extent);
+		return;
+	}
+
+	extent->next = NULL;
+	extent->offset = 0;
+	extent->len = ZOO_IO_MMAP_RANGE_SIZE;
+	zoo_io_mmap_free = extent;
+	zoo_io_mmap_page_size = sysconf(_SC_PAGESIZE);
+
+	__atomic_store_n(&zoo_io_mmap_range, ptr, __ATOMIC_RELAXED);
+	__atomic_store_n(&zoo_io_mmap_range_size, ZOO_IO_MMAP_RANGE_SIZE, __ATOMIC_RELAXED);
+}
+
+// first fit; returns NULL if the range is full
+static uint8_t *zoo_io_mmap_range_alloc(size_t len) {
+	zoo_io_mmap_extent **prev, *extent;
+	uint8_t *ptr = NULL;
+
+	pthread_mutex_lock(&zoo_io_mmap_range_lock);
+	for (prev = &zoo_io_mmap_free; (extent = *prev) != NULL; prev = &extent->next) {
+		if (extent->len >= len) {
+			ptr = zoo_io_mmap_range + extent->offset;
+			extent->offset += len;
+			extent->len -= len;
+			if (extent->len == 0) {
+				*prev = extent->next;
+				free(extent);
+			}
+			break;
+		}
+	}
+	pthread_mutex_unlock(&zoo_io_mmap_range_lock);
+	return ptr;
+}
+
+static void zoo_io_mmap_range_free(uint8_t *ptr, size_t len) {
+	zoo_io_mmap_extent **prev, *extent = NULL, *next;
+	size_t offset = ptr - zoo_io_mmap_range;
+
+	// put the reservation back in place of the mapping
+	if (mmap(ptr, len, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0) == MAP_FAILED)
+		return;
+
+	pthread_mutex_lock(&zoo_io_mmap_range_lock);
+	for (prev = &zoo_io_mmap_free; (next = *prev) != NULL && next->offset < offset; prev = &next->next) {
+		extent = next;
+	}
+	// merge with the neighbouring extents where possible
+	if (prev != &zoo_io_mmap_free && extent->offset + extent->len == offset) {
+		extent->len += len;
+		if (next != NULL && offset + len == next->offset) {
+			extent->len += next->len;
+			extent->next = next->next;
+			free(next);
+		}
+	} else if (next != NULL && offset + len == next->offset) {
+		next->offset = offset;
+		next->len += len;
+	} else {
+		extent = malloc(sizeof(zoo_io_mmap_extent));
+		// out of memory: the space is lost, but stays reserved
+		if (extent != NULL) {
+			extent->next = next;
+			extent->offset = offset;
+			extent->len = len;
+			*prev = extent;
+		}
+	}
+	pthread_mutex_unlock(&zoo_io_mmap_range_lock);
+}
+
+static zoo_io_mmap_file *zoo_io_mmap_find(zoo_io_mmap_driver *drv, struct stat *st) {
+	zoo_io_mmap_file *file;
+
+	for (file = drv->files; file != NULL; file = file->next) {
+		if (file->dev == st->st_dev && file->ino == st->st_ino && file->size == st->st_size
+			&& file->mtime.tv_sec == st->st_mtim.tv_sec && file->mtime.tv_nsec == st->st_mtim.tv_nsec)
+			return file;
+	}
+	return NULL;
+}
+
+static zoo_io_mmap_file *zoo_io_mmap_add(zoo_io_mmap_driver *drv, const char *name, struct stat *st) {
+	zoo_io_mmap_file *file;
+	uint8_t *range;
+	size_t range_len;
+	int fd;
+
+	pthread_once(&zoo_io_mmap_range_once, zoo_io_mmap_range_init);
+
+	// empty files can't be mapped; large ones don't fit a memory handle
+	if (zoo_io_mmap_range == NULL || st->st_size <= 0 || st->st_size > INT_MAX)
+		return NULL;
+
+	range_len = zoo_io_mmap_page_size + ((st->st_size + zoo_io_mmap_page_size - 1) & ~(zoo_io_mmap_page_size - 1));
+	range = zoo_io_mmap_range_alloc(range_len);
+	if (range == NULL)
+		return NULL;
+
+	fd = open(name, O_RDONLY);
+	if (fd < 0)
+		goto fail;
+	if (mmap(range, zoo_io_mmap_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED
+		|| mmap(range + zoo_io_mmap_page_size, st->st_size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+		close(fd);
+		goto fail;
+	}
+	close(fd);
+
+	file = (zoo_io_mmap_file *) range;
+	file->drv = drv;
+	file->refs = 0;
+	file->dev = st->st_dev;
+	file->ino = st->st_ino;
+	file->size = st->st_size;
+	file->mtime = st->st_mtim;
+	file->range_len = range_len;
+	file->ptr = range + zoo_io_mmap_page_size;
+
+	file->next = drv->files;
+	drv->files = file;
+	return file;
+
+fail:
+	zoo_io_mmap_range_free(range, range_len);
+	return NULL;
+}
+
+static void zoo_io_mmap_remove(zoo_io_mmap_file *file) {
+	zoo_io_mmap_file **prev;
+
+	for (prev = &file->drv->files; *prev != file; prev = &(*prev)->next);
+	*prev = file->next;
+	zoo_io_mmap_range_free((uint8_t *) file, file->range_len);
+}
+
+static void zoo_io_mmap_unref(void *arg) {
+	zoo_io_mmap_file *file = (zoo_io_mmap_file *) arg;
+
+	if (--file->refs <= 0)
+		zoo_io_mmap_remove(file);
+}
+
+// the file's record sits in the page before the data handles point to
+static zoo_io_mmap_file *zoo_io_mmap_handle_file(zoo_io_handle *h) {
+	return (zoo_io_mmap_file *) ((uint8_t *) h->p - zoo_io_mmap_page_size);
+}
+
+static void zoo_io_mmap_close(zoo_io_handle *h) {
+	zoo_io_mmap_unref(zoo_io_mmap_handle_file(h));
+}
+
+static zoo_func_io_release zoo_io_mmap_retain(zoo_io_handle *h, void **arg) {
+	zoo_io_mmap_file *file = zoo_io_mmap_handle_file(h);
+
+	file->refs++;
+	*arg = file;
+	return zoo_io_mmap_unref;
+}
+
+static zoo_io_handle zoo_io_open_file_mmap(zoo_io_path_driver *drv, const char *name, zoo_io_mode mode) {
+	zoo_io_mmap_file *file;
+	zoo_io_handle h;
+	struct stat st;
+
+	if (stat(name, &st) != 0 || !S_ISREG(st.st_mode)) {
+		return zoo_io_open_file_posix(drv, name, mode);
+	}
+
+	if (mode == MODE_WRITE) {
+		// replace the file instead of truncating it, so that mappings keep
+		// the old contents (and a failed save leaves it intact)
+		return zoo_io_open_file_posix_replace(drv, name);
+	}
+
+	file = zoo_io_mmap_find((zoo_io_mmap_driver *) drv, &st);
+	if (file == NULL) {
+		file = zoo_io_mmap_add((zoo_io_mmap_driver *) drv, name, &st);
+		if (file == NULL) {
+			return zoo_io_open_file_posix(drv, name, mode);
+		}
+	}
+
+	file->refs++;
+	h = zoo_io_open_file_mem(file->ptr, file->size, MODE_READ);
+	h.func_close = zoo_io_mmap_close;
+	h.func_retain = zoo_io_mmap_retain;
+	return h;
+}
+
+void zoo_io_create_mmap_driver(zoo_io_mmap_driver *drv) {
+	zoo_io_create_posix_driver(&drv->parent);
+	drv->parent.func_open_file_absolute = zoo_io_open_file_mmap;
+	drv->files = NULL;
+}
+
+void zoo_io_free_mmap_driver(zoo_io_mmap_driver *drv) {
+	while (drv->files != NULL) {
+		zoo_io_mmap_remove(drv->files);
+	}
+}
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <dirent.h>
 #include <unistd.h>
@@ -6,65 +7,227 @@
 
 #include <sys/stat.h>
 
+// file handles keep a buffer of their own, which the buffer window points
+// into
+
+#define ZOO_IO_FILE_BUFFER_SIZE 4096
+
+typedef struct {
+	FILE *f;
+	// set by zoo_io_open_file_posix_replace: the file being written is
+	// renamed over replace_name on close
+	char *tmp_name;
+	char *replace_name;
+	uint8_t buffer[ZOO_IO_FILE_BUFFER_SIZE];
+} zoo_io_file;
+
+// MODE_READ
+
 static uint8_t zoo_io_file_getc(zoo_io_handle *h) {
-	FILE *f = (FILE*) h->p;
-	int result = fgetc(f);
-	return (result == EOF) ? 0 : result;
+	zoo_io_file *file = (zoo_io_file*) h->p;
+	size_t len;
+	if (h->buf_pos < h->buf_read_end) return *(h->buf_pos++);
+	len = fread(file->buffer, 1, ZOO_IO_FILE_BUFFER_SIZE, file->f);
+	if (len <= 0) return 0;
+	h->buf_pos = file->buffer + 1;
+	h->buf_read_end = file->buffer + len;
+	return file->buffer[0];
 }
 
-static size_t zoo_io_file_putc(zoo_io_handle *h, uint8_t v) {
-	FILE *f = (FILE*) h->p;
-	return (fputc(v, f) == v) ? 1 : 0;
+static size_t zoo_io_file_read(zoo_io_handle *h, uint8_t *d_ptr, size_t len) {
+	zoo_io_file *file = (zoo_io_file*) h->p;
+	size_t buf_len = h->buf_read_end - h->buf_pos;
+	if (len <= buf_len) {
+		memcpy(d_ptr, h->buf_pos, len);
+		h->buf_pos += len;
+		return len;
+	}
+	memcpy(d_ptr, h->buf_pos, buf_len);
+	h->buf_pos = h->buf_read_end;
+	return buf_len + fread(d_ptr + buf_len, 1, len - buf_len, file->f);
 }
 
-static size_t zoo_io_file_read(zoo_io_handle *h, uint8_t *d_ptr, size_t len) {
-	FILE *f = (FILE*) h->p;
-	return fread(d_ptr, 1, len, f);
+static size_t zoo_io_file_skip_read(zoo_io_handle *h, size_t len) {
+	zoo_io_file *file = (zoo_io_file*) h->p;
+	size_t buf_len = h->buf_read_end - h->buf_pos;
+	if (len <= buf_len) {
+		h->buf_pos += len;
+	} else {
+		h->buf_pos = h->buf_read_end;
+		fseek(file->f, len - buf_len, SEEK_CUR);
+	}
+	return len;
+}
+
+static size_t zoo_io_file_tell_read(zoo_io_handle *h) {
+	zoo_io_file *file = (zoo_io_file*) h->p;
+	return ftell(file->f) - (h->buf_read_end - h->buf_pos);
+}
+
+static size_t zoo_io_file_putc_ro(zoo_io_handle *h, uint8_t v) {
+	return 0;
+}
+
+static size_t zoo_io_file_write_ro(zoo_io_handle *h, const uint8_t *d_ptr, size_t len) {
+	return 0;
+}
+
+// MODE_WRITE
+
+static bool zoo_io_file_flush(zoo_io_handle *h) {
+	zoo_io_file *file = (zoo_io_file*) h->p;
+	size_t len = h->buf_pos - file->buffer;
+	h->buf_pos = file->buffer;
+	return fwrite(file->buffer, 1, len, file->f) == len;
+}
+
+static uint8_t zoo_io_file_getc_wo(zoo_io_handle *h) {
+	return 0;
+}
+
+static size_t zoo_io_file_read_wo(zoo_io_handle *h, uint8_t *d_ptr, size_t len) {
+	return 0;
+}
+
+static size_t zoo_io_file_putc(zoo_io_handle *h, uint8_t v) {
+	if (h->buf_pos >= h->buf_write_end && !zoo_io_file_flush(h)) return 0;
+	*(h->buf_pos++) = v;
+	return 1;
 }
 
 static size_t zoo_io_file_write(zoo_io_handle *h, const uint8_t *d_ptr, size_t len) {
-	FILE *f = (FILE*) h->p;
-	return fwrite(d_ptr, 1, len, f);
+	zoo_io_file *file = (zoo_io_file*) h->p;
+	if (len <= (size_t) (h->buf_write_end - h->buf_pos)) {
+		memcpy(h->buf_pos, d_ptr, len);
+		h->buf_pos += len;
+		return len;
+	}
+	if (!zoo_io_file_flush(h)) return 0;
+	return fwrite(d_ptr, 1, len, file->f);
 }
 
-static size_t zoo_io_file_skip(zoo_io_handle *h, size_t len) {
-	FILE *f = (FILE*) h->p;
+static size_t zoo_io_file_skip_write(zoo_io_handle *h, size_t len) {
+	zoo_io_file *file = (zoo_io_file*) h->p;
+	zoo_io_file_flush(h);
 	// TODO: check if works on writes
-	fseek(f, len, SEEK_CUR);
+	fseek(file->f, len, SEEK_CUR);
 	return len;
 }
 
-static size_t zoo_io_file_tell(zoo_io_handle *h) {
-	FILE *f = (FILE*) h->p;
-	return ftell(f);
+static size_t zoo_io_file_tell_write(zoo_io_handle *h) {
+	zoo_io_file *file = (zoo_io_file*) h->p;
+	return ftell(file->f) + (h->buf_pos - file->buffer);
 }
 
 static void zoo_io_file_close(zoo_io_handle *h) {
-	FILE *f = (FILE*) h->p;
-	fclose(f);
+	zoo_io_file *file = (zoo_io_file*) h->p;
+	bool ok = true;
+	if (h->buf_write_end != file->buffer)
+		ok = zoo_io_file_flush(h);
+	ok = (fclose(file->f) == 0) && ok;
+	if (file->tmp_name != NULL) {
+		// only replace the original once the new file is complete
+		if (!ok || rename(file->tmp_name, file->replace_name) != 0)
+			unlink(file->tmp_name);
+		free(file->tmp_name);
+		free(file->replace_name);
+	}
+	free(file);
 }
 
-static zoo_io_handle zoo_io_open_file_posix(zoo_io_path_driver *drv, const char *name, zoo_io_mode mode) {
-	FILE *file;
+static zoo_io_handle zoo_io_file_handle(zoo_io_file *file, zoo_io_mode mode) {
 	zoo_io_handle h;
 
-	file = fopen(name, mode == MODE_WRITE ? "wb" : "rb");
-	if (file == NULL) {
-		return zoo_io_open_file_empty();
-	}
-
 	h.p = file;
+	h.len = 0;
+	h.buf_pos = file->buffer;
+	h.buf_read_end = file->buffer;
+	h.buf_write_end = file->buffer;
 	h.func_getptr = NULL;
-	h.func_getc = zoo_io_file_getc;
-	h.func_putc = zoo_io_file_putc;
-	h.func_read = zoo_io_file_read;
-	h.func_write = zoo_io_file_write;
-	h.func_skip = zoo_io_file_skip;
-	h.func_tell = zoo_io_file_tell;
+	if (mode == MODE_WRITE) {
+		h.buf_write_end = file->buffer + ZOO_IO_FILE_BUFFER_SIZE;
+		h.func_getc = zoo_io_file_getc_wo;
+		h.func_putc = zoo_io_file_putc;
+		h.func_read = zoo_io_file_read_wo;
+		h.func_write = zoo_io_file_write;
+		h.func_skip = zoo_io_file_skip_write;
+		h.func_tell = zoo_io_file_tell_write;
+	} else {
+		h.func_getc = zoo_io_file_getc;
+		h.func_putc = zoo_io_file_putc_ro;
+		h.func_read = zoo_io_file_read;
+		h.func_write = zoo_io_file_write_ro;
+		h.func_skip = zoo_io_file_skip_read;
+		h.func_tell = zoo_io_file_tell_read;
+	}
 	h.func_close = zoo_io_file_close;
+	h.func_retain = NULL;
 	return h;
 }
 
+zoo_io_handle zoo_io_open_file_posix(zoo_io_path_driver *drv, const char *name, zoo_io_mode mode) {
+	zoo_io_file *file;
+
+	file = malloc(sizeof(zoo_io_file));
+	if (file == NULL) {
+		return zoo_io_open_file_empty();
+	}
+
+	file->f = fopen(name, mode == MODE_WRITE ? "wb" : "rb");
+	if (file->f == NULL) {
+		free(file);
+		return zoo_io_open_file_empty();
+	}
+	file->tmp_name = NULL;
+	file->replace_name = NULL;
+
+	return zoo_io_file_handle(file, mode);
+}
+
+zoo_io_handle zoo_io_open_file_posix_replace(zoo_io_path_driver *drv, const char *name) {
+	zoo_io_file *file;
+	struct stat st;
+	size_t len = strlen(name);
+	int fd;
+
+	file = malloc(sizeof(zoo_io_file));
+	if (file == NULL) {
+		return zoo_io_open_file_empty();
+	}
+
+	file->tmp_name = malloc(len + 8);
+	file->replace_name = malloc(len + 1);
+	if (file->tmp_name == NULL || file->replace_name == NULL) {
+		goto fail;
+	}
+	memcpy(file->replace_name, name, len + 1);
+	memcpy(file->tmp_name, name, len);
+	memcpy(file->tmp_name + len, ".XXXXXX", 8);
+
+	fd = mkstemp(file->tmp_name);
+	if (fd < 0) {
+		goto fail;
+	}
+	// mkstemp creates the file private to the user
+	if (stat(name, &st) == 0) {
+		fchmod(fd, st.st_mode & 07777);
+	}
+	file->f = fdopen(fd, "wb");
+	if (file->f == NULL) {
+		close(fd);
+		unlink(file->tmp_name);
+		goto fail;
+	}
+
+	return zoo_io_file_handle(file, MODE_WRITE);
+
+fail:
+	free(file->tmp_name);
+	free(file->replace_name);
+	free(file);
+	return zoo_io_open_file_empty();
+}
+
 static inline int64_t zoo_io_get_mtime(const char *basename, const char *name) {
 	struct stat statinfo;
 	char path[ZOO_PATH_MAX + 1];
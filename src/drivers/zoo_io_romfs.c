@@ -7,7 +7,7 @@
 
 // TODO: add support for directories
 
-static enum {
+typedef enum {
 	ROMFS_TYPE_HLINK = 0,
 	ROMFS_TYPE_DIR = 1,
 	ROMFS_TYPE_FILE = 2,
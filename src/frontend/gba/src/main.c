@@ -153,7 +153,7 @@ int main(void) {
 
 			tick_in_progress = true;
 			while (tick_in_progress) {
-				switch (zoo_tick(&state)) {
+				switch (zoo_tick_cycle(&state, 0)) {
 					case RETURN_IMMEDIATE:
 						break;
 					case RETURN_NEXT_FRAME:
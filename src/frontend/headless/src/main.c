@@ -0,0 +1,686 @@
+/**
+ * Copyright (c) 2020 Adrian Siekierka
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Headless batch runner: plays every world in a directory for a fixed
+// number of cycles, without video or sound, spread across a thread pool.
+// With -S, it instead checks that many zoo_state instances ticking in
+// parallel produce the same output as each world run alone; -R and -B
+// check saving/reloading and oop_frame_budget the same way.
+
+#include <ctype.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "zoo.h"
+#include "zoo_io_posix.h"
+#ifdef ZOO_USE_DRIVER_IO_MMAP
+#include "zoo_io_mmap.h"
+#endif
+
+// how many frames a waiting call stack (window, etc.) may take before
+// the world is considered stuck
+#define HEADLESS_MAX_STALL_FRAMES 20000
+
+// reload_error for a save file which could not be opened
+#define HEADLESS_ERROR_OPEN 1
+
+typedef struct {
+	char name[ZOO_PATH_MAX + 1];
+	uint32_t cycles;
+	double seconds;
+	int load_error;
+	int16_t error_value;
+	bool stalled;
+	uint64_t hash;
+	bool reload; // save and reload halfway through (reload mode)
+	int reload_error;
+	uint16_t oop_frame_budget; // budget mode
+	uint32_t oop_frame_yields;
+} headless_world;
+
+typedef struct {
+	zoo_video_driver parent;
+	uint64_t hash;
+} headless_video_driver;
+
+typedef struct {
+	pthread_mutex_t lock;
+	int *items;
+	int head, tail;
+} headless_queue;
+
+typedef struct {
+	int id;
+	pthread_t thread;
+} headless_worker;
+
+static char corpus_path[ZOO_PATH_MAX + 1];
+static uint32_t opt_cycles = 10000;
+static int opt_threads = 0;
+static uint32_t opt_seed = 1;
+static const char *opt_script = NULL;
+static bool opt_quiet = false;
+static int opt_stress_copies = 0;
+static size_t opt_board_cache = 0;
+static const char *opt_reload_path = NULL;
+static uint16_t opt_oop_frame_budget = 0;
+static bool opt_hash = false;
+#ifdef ZOO_PROFILE
+static const char *opt_profile_path = NULL;
+#endif
+
+static headless_world *worlds;
+static int world_count;
+static int world_alloc;
+
+static headless_world *runs;
+static headless_queue *queues;
+static headless_worker *workers;
+static int worker_count;
+
+// world list
+
+static bool headless_is_world(const char *name) {
+	size_t len = strlen(name);
+	const char *ext = "ZZT";
+	int i;
+
+	if (len < 5 || name[len - 4] != '.') return false;
+	for (i = 0; i < 3; i++) {
+		if (toupper((unsigned char) name[len - 3 + i]) != ext[i]) return false;
+	}
+	return true;
+}
+
+static bool headless_scan_cb(zoo_io_path_driver *drv, zoo_io_dirent *e, void *arg) {
+	if (e->type == TYPE_FILE && headless_is_world(e->name)) {
+		if (world_count >= world_alloc) {
+			world_alloc = world_alloc > 0 ? world_alloc * 2 : 64;
+			worlds = realloc(worlds, sizeof(headless_world) * world_alloc);
+		}
+		memset(&worlds[world_count], 0, sizeof(headless_world));
+		snprintf(worlds[world_count].name, sizeof(worlds[world_count].name), "%s", e->name);
+		world_count++;
+	}
+	return true;
+}
+
+static int headless_world_cmp(const void *a, const void *b) {
+	return strcmp(((const headless_world*) a)->name, ((const headless_world*) b)->name);
+}
+
+// input
+
+static uint32_t headless_rand(uint32_t *seed) {
+	*seed = (*seed * 1103515245) + 12345;
+	return (*seed >> 16) & 0x7FFF;
+}
+
+/**
+ * Script characters, one per cycle (the script loops):
+ * U, D, L, R - move; u, d, l, r - shoot; T - torch; O - OK; C - cancel; . - idle
+ */
+static void headless_input_script(zoo_state *state, char c) {
+	zoo_input_state *input = &state->input;
+	char lc = tolower((unsigned char) c);
+
+	zoo_input_action_set(input, ZOO_ACTION_UP, lc == 'u');
+	zoo_input_action_set(input, ZOO_ACTION_DOWN, lc == 'd');
+	zoo_input_action_set(input, ZOO_ACTION_LEFT, lc == 'l');
+	zoo_input_action_set(input, ZOO_ACTION_RIGHT, lc == 'r');
+	zoo_input_action_set(input, ZOO_ACTION_SHOOT, c == 'u' || c == 'd' || c == 'l' || c == 'r');
+	zoo_input_action_set(input, ZOO_ACTION_TORCH, c == 'T');
+	zoo_input_action_set(input, ZOO_ACTION_OK, c == 'O');
+	zoo_input_action_set(input, ZOO_ACTION_CANCEL, c == 'C');
+}
+
+static void headless_input_random(zoo_state *state, uint32_t *seed) {
+	zoo_input_state *input = &state->input;
+	int dir = headless_rand(seed) % 6;
+	int i;
+
+	for (i = 0; i < 4; i++) {
+		zoo_input_action_set(input, ZOO_ACTION_UP + i, dir == i);
+	}
+	zoo_input_action_set(input, ZOO_ACTION_SHOOT, (headless_rand(seed) & 7) == 0);
+	zoo_input_action_set(input, ZOO_ACTION_TORCH, (headless_rand(seed) & 63) == 0);
+	zoo_input_action_set(input, ZOO_ACTION_OK, (headless_rand(seed) & 3) == 0);
+	zoo_input_action_set(input, ZOO_ACTION_CANCEL, false);
+}
+
+static void headless_input(zoo_state *state, uint32_t *seed, uint32_t step) {
+	if (opt_script != NULL && opt_script[0] != '\0') {
+		headless_input_script(state, opt_script[step % strlen(opt_script)]);
+	} else {
+		headless_input_random(state, seed);
+	}
+}
+
+// output hashing (stress, reload and budget modes)
+
+#define HEADLESS_HASH_INIT 14695981039346656037ULL
+
+static uint64_t headless_hash(uint64_t hash, uint32_t value) {
+	int i;
+	for (i = 0; i < 4; i++, value >>= 8) {
+		hash = (hash ^ (value & 0xFF)) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+static void headless_video_write(zoo_video_driver *drv, int16_t x, int16_t y, uint8_t col, uint8_t chr) {
+	headless_video_driver *hdrv = (headless_video_driver*) drv;
+	hdrv->hash = headless_hash(hdrv->hash, (x << 24) | (y << 16) | (col << 8) | chr);
+}
+
+static uint64_t headless_state_hash(zoo_state *state, uint64_t hash) {
+	hash = headless_hash(hash, state->cycle_count);
+	hash = headless_hash(hash, state->world.info.current_board);
+	hash = headless_hash(hash, state->world.info.health);
+	hash = headless_hash(hash, state->world.info.ammo);
+	hash = headless_hash(hash, state->world.info.gems);
+	hash = headless_hash(hash, state->world.info.score);
+	hash = headless_hash(hash, state->board.stat_count);
+	hash = headless_hash(hash, state->random_seed);
+	return hash;
+}
+
+// world runner
+
+static double headless_time(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + (ts.tv_nsec / 1000000000.0);
+}
+
+// saves the world to <world>.SAV in the reload directory, then loads it
+// back into the same state
+static int headless_save_reload(zoo_state *state, zoo_io_path_driver *io_driver, headless_world *world) {
+	char path[ZOO_PATH_MAX * 2 + 8];
+	zoo_io_handle h;
+	int ret;
+
+	snprintf(path, sizeof(path), "%s/%.*s.SAV", opt_reload_path, (int) (strlen(world->name) - 4), world->name);
+	h = io_driver->func_open_file_absolute(io_driver, path, MODE_WRITE);
+	if (zoo_io_file_is_empty(&h))
+		return HEADLESS_ERROR_OPEN;
+	ret = zoo_world_save(state, &h);
+	h.func_close(&h);
+	if (ret) return ret;
+
+	h = io_driver->func_open_file_absolute(io_driver, path, MODE_READ);
+	if (zoo_io_file_is_empty(&h))
+		return HEADLESS_ERROR_OPEN;
+	ret = zoo_world_load(state, &h, false);
+	h.func_close(&h);
+	return ret;
+}
+
+#ifdef ZOO_PROFILE
+static uint32_t headless_time_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// writes <world>.json and <world>.csv to the profile directory
+static void headless_write_profile(zoo_state *state, zoo_io_path_driver *io_driver, headless_world *world) {
+	static const char *exts[2] = {"json", "csv"};
+	static const zoo_profile_format formats[2] = {ZOO_PROFILE_JSON, ZOO_PROFILE_CSV};
+	char path[ZOO_PATH_MAX * 2 + 8];
+	zoo_io_handle h;
+	int i;
+
+	for (i = 0; i < 2; i++) {
+		snprintf(path, sizeof(path), "%s/%.*s.%s", opt_profile_path, (int) (strlen(world->name) - 4), world->name, exts[i]);
+		h = io_driver->func_open_file_absolute(io_driver, path, MODE_WRITE);
+		if (zoo_io_file_is_empty(&h)) {
+			fprintf(stderr, "could not open %s\n", path);
+			continue;
+		}
+		zoo_profile_write(state, &h, formats[i]);
+		h.func_close(&h);
+	}
+}
+#endif
+
+static void headless_run_world(headless_world *world) {
+	zoo_state *state;
+#ifdef ZOO_USE_DRIVER_IO_MMAP
+	zoo_io_mmap_driver io_driver;
+#else
+	zoo_io_path_driver io_driver;
+#endif
+	zoo_io_path_driver *io_path = (zoo_io_path_driver *) &io_driver;
+	headless_video_driver video_driver;
+	zoo_io_handle h;
+	uint32_t input_seed = opt_seed;
+	uint32_t step = 0;
+	uint32_t ran;
+	int stall_frames = 0;
+	double time_start;
+
+	state = malloc(sizeof(zoo_state));
+	if (state == NULL) {
+		world->load_error = ZOO_ERROR_NOMEM;
+		return;
+	}
+
+	zoo_state_init(state);
+#ifdef ZOO_USE_DRIVER_IO_MMAP
+	zoo_io_create_mmap_driver(&io_driver);
+#else
+	zoo_io_create_posix_driver(&io_driver);
+#endif
+	snprintf(io_path->path, sizeof(io_path->path), "%s", corpus_path);
+	state->d_io = &io_path->parent;
+	state->random_seed = opt_seed;
+	state->oop_frame_budget = world->oop_frame_budget;
+	zoo_board_cache_set_limit(state, opt_board_cache);
+#ifdef ZOO_PROFILE
+	if (opt_profile_path != NULL && !zoo_profile_enable(state, headless_time_ns, "ns")) {
+		world->load_error = ZOO_ERROR_NOMEM;
+		free(state);
+		return;
+	}
+#endif
+	if (opt_hash) {
+		memset(&video_driver, 0, sizeof(video_driver));
+		video_driver.parent.func_write = headless_video_write;
+		video_driver.hash = HEADLESS_HASH_INIT;
+		state->d_video = &video_driver.parent;
+	}
+
+	h = io_path->parent.func_open_file(&io_path->parent, world->name, MODE_READ);
+	world->load_error = zoo_world_load(state, &h, false);
+	h.func_close(&h);
+
+	if (world->load_error == 0) {
+		world->load_error = zoo_world_play(state);
+	}
+
+	if (world->load_error == 0) {
+		time_start = headless_time();
+		while (world->cycles < opt_cycles && state->error_value == 0) {
+			if (world->reload && world->cycles >= opt_cycles / 2 && state->call_stack.call == NULL) {
+				world->reload = false;
+				world->reload_error = headless_save_reload(state, io_path, world);
+				if (world->reload_error != 0) break;
+			}
+			headless_input(state, &input_seed, step++);
+			ran = zoo_run_ticks(state, 1);
+			world->cycles += ran;
+			if (ran == 0 && state->error_value == 0) {
+				// the call stack is waiting for input - play a frame
+				if (state->game_state == GS_NONE || (++stall_frames) > HEADLESS_MAX_STALL_FRAMES) {
+					world->stalled = true;
+					break;
+				}
+				zoo_tick_advance_pit(state);
+				zoo_sound_tick(&state->sound);
+				zoo_input_tick(&state->input);
+			} else {
+				stall_frames = 0;
+			}
+		}
+		world->seconds = headless_time() - time_start;
+		world->error_value = state->error_value;
+		world->oop_frame_yields = state->oop_frame_yields;
+#ifdef ZOO_PROFILE
+		if (opt_profile_path != NULL) {
+			headless_write_profile(state, io_path, world);
+		}
+#endif
+		if (opt_hash) {
+			world->hash = headless_state_hash(state, video_driver.hash);
+		}
+	}
+
+	zoo_world_close(state);
+#ifdef ZOO_USE_DRIVER_IO_MMAP
+	zoo_io_free_mmap_driver(&io_driver);
+#endif
+#ifdef ZOO_PROFILE
+	zoo_profile_disable(state);
+#endif
+	free(state);
+}
+
+// thread pool with work stealing: every worker owns a queue of world
+// indices; it pops from the back of its own queue and, once that is
+// empty, steals from the front of the others
+
+static bool headless_queue_pop(headless_queue *q, int *item) {
+	bool result = false;
+
+	pthread_mutex_lock(&q->lock);
+	if (q->head < q->tail) {
+		*item = q->items[--q->tail];
+		result = true;
+	}
+	pthread_mutex_unlock(&q->lock);
+	return result;
+}
+
+static bool headless_queue_steal(headless_queue *q, int *item) {
+	bool result = false;
+
+	pthread_mutex_lock(&q->lock);
+	if (q->head < q->tail) {
+		*item = q->items[q->head++];
+		result = true;
+	}
+	pthread_mutex_unlock(&q->lock);
+	return result;
+}
+
+static void *headless_worker_main(void *arg) {
+	headless_worker *worker = (headless_worker*) arg;
+	int item, i;
+
+	while (true) {
+		if (!headless_queue_pop(&queues[worker->id], &item)) {
+			for (i = 1; i < worker_count; i++) {
+				if (headless_queue_steal(&queues[(worker->id + i) % worker_count], &item)) {
+					break;
+				}
+			}
+			if (i >= worker_count) {
+				// nothing left anywhere
+				return NULL;
+			}
+		}
+
+		headless_run_world(&runs[item]);
+		if (!opt_quiet) {
+			fprintf(stderr, "[%d] %s: %u cycles\n", worker->id, runs[item].name, runs[item].cycles);
+		}
+	}
+}
+
+static void headless_run_pool(headless_world *pool_runs, int count, int threads) {
+	int i;
+
+	runs = pool_runs;
+	worker_count = threads < count ? threads : count;
+
+	// deal runs out round-robin; stealing evens out the rest
+	queues = calloc(worker_count, sizeof(headless_queue));
+	workers = calloc(worker_count, sizeof(headless_worker));
+	for (i = 0; i < worker_count; i++) {
+		pthread_mutex_init(&queues[i].lock, NULL);
+		queues[i].items = malloc(sizeof(int) * (count / worker_count + 1));
+	}
+	for (i = 0; i < count; i++) {
+		queues[i % worker_count].items[queues[i % worker_count].tail++] = i;
+	}
+
+	for (i = 0; i < worker_count; i++) {
+		workers[i].id = i;
+		pthread_create(&workers[i].thread, NULL, headless_worker_main, &workers[i]);
+	}
+	for (i = 0; i < worker_count; i++) {
+		pthread_join(workers[i].thread, NULL);
+	}
+
+	for (i = 0; i < worker_count; i++) {
+		pthread_mutex_destroy(&queues[i].lock);
+		free(queues[i].items);
+	}
+	free(queues);
+	free(workers);
+}
+
+static bool headless_world_same(headless_world *a, headless_world *b) {
+	return a->hash == b->hash && a->cycles == b->cycles
+		&& a->error_value == b->error_value && a->load_error == b->load_error;
+}
+
+// stress mode: run every world alone for reference output, then run
+// opt_stress_copies instances of each world at once and compare
+
+static int headless_stress(void) {
+	headless_world *copies;
+	int copy_count = world_count * opt_stress_copies;
+	int failures = 0;
+	int i;
+
+	headless_run_pool(worlds, world_count, 1);
+
+	copies = malloc(sizeof(headless_world) * copy_count);
+	for (i = 0; i < copy_count; i++) {
+		memset(&copies[i], 0, sizeof(headless_world));
+		snprintf(copies[i].name, sizeof(copies[i].name), "%s", worlds[i % world_count].name);
+	}
+	headless_run_pool(copies, copy_count, opt_threads);
+
+	for (i = 0; i < copy_count; i++) {
+		headless_world *ref = &worlds[i % world_count];
+		if (!headless_world_same(&copies[i], ref)) {
+			printf("%s: copy %d differs (%016llx, %u cycles; expected %016llx, %u cycles)\n",
+				ref->name, i / world_count,
+				(unsigned long long) copies[i].hash, copies[i].cycles,
+				(unsigned long long) ref->hash, ref->cycles);
+			failures++;
+		}
+	}
+
+	printf("%d worlds x %d copies on %d threads: %d mismatches\n",
+		world_count, opt_stress_copies, worker_count, failures);
+	free(copies);
+	free(worlds);
+	return failures > 0 ? 1 : 0;
+}
+
+// reload mode: run every world as it is for reference output, then again
+// saved to and loaded back from opt_reload_path halfway through, and compare
+
+static int headless_reload_check(void) {
+	headless_world *copies;
+	int failures = 0;
+	int i;
+
+	headless_run_pool(worlds, world_count, opt_threads);
+
+	copies = malloc(sizeof(headless_world) * world_count);
+	for (i = 0; i < world_count; i++) {
+		memset(&copies[i], 0, sizeof(headless_world));
+		snprintf(copies[i].name, sizeof(copies[i].name), "%s", worlds[i].name);
+		copies[i].reload = true;
+	}
+	headless_run_pool(copies, world_count, opt_threads);
+
+	for (i = 0; i < world_count; i++) {
+		headless_world *ref = &worlds[i];
+		if (copies[i].reload_error != 0) {
+			printf("%s: save/reload failed (error %d)\n", ref->name, copies[i].reload_error);
+			failures++;
+		} else if (!headless_world_same(&copies[i], ref)) {
+			printf("%s: differs after reload (%016llx, %u cycles; expected %016llx, %u cycles)\n",
+				ref->name,
+				(unsigned long long) copies[i].hash, copies[i].cycles,
+				(unsigned long long) ref->hash, ref->cycles);
+			failures++;
+		}
+	}
+
+	printf("%d worlds saved and reloaded: %d mismatches\n", world_count, failures);
+	free(copies);
+	free(worlds);
+	return failures > 0 ? 1 : 0;
+}
+
+// budget mode: run every world as it is for reference output, then again
+// with opt_oop_frame_budget, and compare - yielding mid-cycle must not
+// change anything but how the cycle is split across frames
+
+static int headless_budget_check(void) {
+	headless_world *copies;
+	uint64_t yields = 0;
+	int failures = 0;
+	int i;
+
+	headless_run_pool(worlds, world_count, opt_threads);
+
+	copies = malloc(sizeof(headless_world) * world_count);
+	for (i = 0; i < world_count; i++) {
+		memset(&copies[i], 0, sizeof(headless_world));
+		snprintf(copies[i].name, sizeof(copies[i].name), "%s", worlds[i].name);
+		copies[i].oop_frame_budget = opt_oop_frame_budget;
+	}
+	headless_run_pool(copies, world_count, opt_threads);
+
+	for (i = 0; i < world_count; i++) {
+		headless_world *ref = &worlds[i];
+		if (!headless_world_same(&copies[i], ref)) {
+			printf("%s: differs with a budget (%016llx, %u cycles; expected %016llx, %u cycles)\n",
+				ref->name,
+				(unsigned long long) copies[i].hash, copies[i].cycles,
+				(unsigned long long) ref->hash, ref->cycles);
+			failures++;
+		}
+		yields += copies[i].oop_frame_yields;
+	}
+
+	printf("%d worlds with a budget of %u commands (%llu yields): %d mismatches\n",
+		world_count, opt_oop_frame_budget, (unsigned long long) yields, failures);
+	free(copies);
+	free(worlds);
+	return failures > 0 ? 1 : 0;
+}
+
+// main
+
+static void headless_usage(const char *name) {
+	fprintf(stderr, "usage: %s [-c cycles] [-j threads] [-s seed] [-i script] [-S copies] [-b cache KiB] [-R directory] [-B commands] [-q] directory\n", name);
+	fprintf(stderr, "  -R directory: check that saving to directory and reloading halfway through changes nothing\n");
+	fprintf(stderr, "  -B commands: check that yielding every so many OOP commands (oop_frame_budget) changes nothing\n");
+#ifdef ZOO_PROFILE
+	fprintf(stderr, "  -P directory: write a tick profile of every world to directory\n");
+#endif
+	fprintf(stderr, "  script characters: U/D/L/R move, u/d/l/r shoot, T torch, O ok, C cancel, . idle\n");
+}
+
+int main(int argc, char **argv) {
+	zoo_io_path_driver scan_driver;
+	struct rusage usage;
+	uint64_t total_cycles = 0;
+	double total_seconds = 0.0;
+	double time_start, time_end;
+	int failures = 0;
+	int opt, i;
+
+	while ((opt = getopt(argc, argv, "c:j:s:i:S:b:R:B:P:qh")) != -1) {
+		switch (opt) {
+			case 'c': opt_cycles = strtoul(optarg, NULL, 0); break;
+			case 'j': opt_threads = atoi(optarg); break;
+			case 's': opt_seed = strtoul(optarg, NULL, 0); break;
+			case 'i': opt_script = optarg; break;
+			case 'S': opt_stress_copies = atoi(optarg); break;
+			case 'b': opt_board_cache = strtoul(optarg, NULL, 0) * 1024; break;
+			case 'R': opt_reload_path = optarg; break;
+			case 'B': opt_oop_frame_budget = strtoul(optarg, NULL, 0); break;
+			case 'q': opt_quiet = true; break;
+#ifdef ZOO_PROFILE
+			case 'P': opt_profile_path = optarg; break;
+#endif
+			default:
+				headless_usage(argv[0]);
+				return 1;
+		}
+	}
+
+	if (optind >= argc) {
+		headless_usage(argv[0]);
+		return 1;
+	}
+
+	snprintf(corpus_path, sizeof(corpus_path), "%s", argv[optind]);
+	zoo_io_create_posix_driver(&scan_driver);
+	if (!scan_driver.func_dir_scan(&scan_driver, corpus_path, headless_scan_cb, NULL)) {
+		fprintf(stderr, "could not open directory %s\n", corpus_path);
+		return 1;
+	}
+	if (world_count == 0) {
+		fprintf(stderr, "no worlds found in %s\n", corpus_path);
+		return 1;
+	}
+	qsort(worlds, world_count, sizeof(headless_world), headless_world_cmp);
+
+	if (opt_threads <= 0) {
+		opt_threads = sysconf(_SC_NPROCESSORS_ONLN);
+		if (opt_threads <= 0) opt_threads = 1;
+	}
+
+	opt_hash = opt_stress_copies > 0 || opt_reload_path != NULL || opt_oop_frame_budget > 0;
+	if (opt_stress_copies > 0) {
+		return headless_stress();
+	}
+	if (opt_reload_path != NULL) {
+		return headless_reload_check();
+	}
+	if (opt_oop_frame_budget > 0) {
+		return headless_budget_check();
+	}
+
+	time_start = headless_time();
+	headless_run_pool(worlds, world_count, opt_threads);
+	time_end = headless_time();
+
+	printf("world\tcycles\tseconds\tcycles/sec\tstatus\n");
+	for (i = 0; i < world_count; i++) {
+		headless_world *world = &worlds[i];
+		printf("%s\t%u\t%.3f\t%.0f\t", world->name, world->cycles, world->seconds,
+			world->seconds > 0.0 ? world->cycles / world->seconds : 0.0);
+		if (world->load_error != 0) {
+			printf("load error %d\n", world->load_error);
+			failures++;
+		} else if (world->error_value != 0) {
+			printf("error %d\n", world->error_value);
+			failures++;
+		} else if (world->stalled) {
+			printf("stalled\n");
+		} else {
+			printf("ok\n");
+		}
+		total_cycles += world->cycles;
+		total_seconds += world->seconds;
+	}
+
+	getrusage(RUSAGE_SELF, &usage);
+	printf("\n%d worlds, %d failed, %d threads\n", world_count, failures, worker_count);
+	printf("%llu cycles in %.3f s wall (%.0f cycles/sec), %.0f cycles/sec per thread\n",
+		(unsigned long long) total_cycles, time_end - time_start,
+		(time_end > time_start) ? total_cycles / (time_end - time_start) : 0.0,
+		total_seconds > 0.0 ? total_cycles / total_seconds : 0.0);
+	printf("peak memory: %ld KiB\n", usage.ru_maxrss);
+
+	free(worlds);
+
+	return failures > 0 ? 1 : 0;
+}
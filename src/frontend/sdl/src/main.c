@@ -29,6 +29,9 @@
 
 #include "zoo.h"
 #include "zoo_io_posix.h"
+#ifdef ZOO_USE_DRIVER_IO_MMAP
+#include "zoo_io_mmap.h"
+#endif
 #include "zoo_sidebar.h"
 #include "zoo_sound_pcm.h"
 #include "zoo_ui.h"
@@ -45,7 +48,11 @@ extern uint8_t res_8x14_bin[];
 
 static zoo_state state;
 static zoo_ui_state ui_state;
+#ifdef ZOO_USE_DRIVER_IO_MMAP
+static zoo_io_mmap_driver io_driver;
+#else
 static zoo_io_path_driver io_driver;
+#endif
 static zoo_sound_pcm_driver pcm_driver;
 
 static video_buffer video;
@@ -153,7 +160,7 @@ static uint32_t sdl_game_tick(uint32_t interval, void *param) {
 	zoo_ui_tick(&ui_state);
 
 	while (ticking) {
-		switch (zoo_tick(&state)) {
+		switch (zoo_tick_cycle(&state, 0)) {
 			case RETURN_IMMEDIATE:
 				break;
 			case RETURN_NEXT_FRAME:
@@ -175,6 +182,15 @@ void sdl_draw_char(zoo_video_driver *drv, int16_t x, int16_t y, uint8_t col, uin
 	playfield_changed = true;
 }
 
+#ifdef ZOO_USE_VIDEO_BATCH
+void sdl_draw_span(zoo_video_driver *drv, int16_t x, int16_t y, int16_t width, const uint8_t *data) {
+	for (; width > 0; width--, x++, data += 2) {
+		software_draw_char(&render_opts, playfield_buffer, playfield_pitch, x, y, data[0], data[1]);
+	}
+	playfield_changed = true;
+}
+#endif
+
 void sdl_render(void) {
 	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
 	SDL_RenderClear(renderer);
@@ -254,11 +270,19 @@ int main(int argc, char **argv) {
 	srand(time(NULL));
 
 	zoo_state_init(&state);
+#ifdef ZOO_USE_DRIVER_IO_MMAP
+	zoo_io_create_mmap_driver(&io_driver);
+#else
 	zoo_io_create_posix_driver(&io_driver);
+#endif
 	video_driver.func_write = sdl_draw_char;
-	state.d_io = &io_driver.parent;
+#ifdef ZOO_USE_VIDEO_BATCH
+	video_driver.func_write_span = sdl_draw_span;
+#endif
+	state.d_io = (zoo_io_driver *) &io_driver;
 	state.d_video = &video_driver;
 	state.random_seed = rand();
+	zoo_board_cache_set_limit(&state, 1024 * 1024);
 
 	if (use_slim_ui) {
 		state.func_draw_sidebar = zoo_draw_sidebar_slim;
@@ -76,14 +76,114 @@ static int16_t zoo_default_random(zoo_state *state, int16_t max) {
 	return state->random_seed % max;
 }
 
+void zoo_video_write(zoo_state *state, int16_t x, int16_t y, uint8_t col, uint8_t chr) {
+#ifdef ZOO_USE_VIDEO_BATCH
+	uint8_t *cell;
+#endif
+
+	ZOO_METRICS_ADD(state, video_writes, 1);
+
+#ifdef ZOO_USE_VIDEO_BATCH
+	if (ZOO_VIDEO_BATCHED(state->d_video) && x >= 0 && y >= 0 && x < ZOO_BOARD_WIDTH && y < ZOO_BOARD_HEIGHT) {
+		cell = &(state->video_buffer[y][x << 1]);
+		cell[0] = col;
+		cell[1] = chr;
+		state->video_dirty[y][x >> 5] |= (1UL << (x & 31));
+		state->video_dirty_rows |= (1UL << y);
+		return;
+	}
+#endif
+	if (state->d_video->func_write != NULL) {
+		state->d_video->func_write(state->d_video, x, y, col, chr);
+	}
+}
+
+#ifdef ZOO_USE_VIDEO_BATCH
+
+#define ZOO_VIDEO_DIRTY(state, x, y) ((state)->video_dirty[y][(x) >> 5] & (1UL << ((x) & 31)))
+
+static bool zoo_video_all_dirty(zoo_state *state) {
+	int16_t iy, i;
+
+	if (state->video_dirty_rows != ((1UL << ZOO_BOARD_HEIGHT) - 1)) {
+		return false;
+	}
+	for (iy = 0; iy < ZOO_BOARD_HEIGHT; iy++) {
+		for (i = 0; i < (ZOO_BOARD_WIDTH >> 5); i++) {
+			if (state->video_dirty[iy][i] != 0xFFFFFFFFUL) return false;
+		}
+		if ((ZOO_BOARD_WIDTH & 31) && state->video_dirty[iy][i] != ((1UL << (ZOO_BOARD_WIDTH & 31)) - 1)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void zoo_video_flush_span(zoo_state *state, int16_t x, int16_t y, int16_t width) {
+	zoo_video_driver *d_video = state->d_video;
+	const uint8_t *data = &(state->video_buffer[y][x << 1]);
+
+	if (d_video->func_write_span != NULL) {
+		d_video->func_write_span(d_video, x, y, width, data);
+	} else if (d_video->func_write_rect != NULL) {
+		d_video->func_write_rect(d_video, x, y, width, 1, data, ZOO_BOARD_WIDTH * 2);
+	} else if (d_video->func_write != NULL) {
+		// driver was swapped out with cells still pending
+		for (; width > 0; width--, x++, data += 2) {
+			d_video->func_write(d_video, x, y, data[0], data[1]);
+		}
+	}
+}
+
+void zoo_video_flush(zoo_state *state) {
+	int16_t ix, iy, start;
+
+	if (state->video_dirty_rows == 0) {
+		return;
+	}
+
+	if (state->d_video->func_write_rect != NULL && zoo_video_all_dirty(state)) {
+		// full redraw
+		state->d_video->func_write_rect(state->d_video, 0, 0, ZOO_BOARD_WIDTH, ZOO_BOARD_HEIGHT,
+			&(state->video_buffer[0][0]), ZOO_BOARD_WIDTH * 2);
+	} else {
+		for (iy = 0; iy < ZOO_BOARD_HEIGHT; iy++) {
+			if (!(state->video_dirty_rows & (1UL << iy))) continue;
+
+			ix = 0;
+			while (ix < ZOO_BOARD_WIDTH) {
+				if (state->video_dirty[iy][ix >> 5] == 0) {
+					ix = (ix + 32) & ~31;
+					continue;
+				}
+				if (!ZOO_VIDEO_DIRTY(state, ix, iy)) {
+					ix++;
+					continue;
+				}
+
+				start = ix;
+				while (ix < ZOO_BOARD_WIDTH && ZOO_VIDEO_DIRTY(state, ix, iy)) ix++;
+				zoo_video_flush_span(state, start, iy, ix - start);
+			}
+		}
+	}
+
+	memset(state->video_dirty, 0, sizeof(state->video_dirty));
+	state->video_dirty_rows = 0;
+}
+#endif
+
 void* zoo_store_display(zoo_state *state, int16_t x, int16_t y, int16_t width, int16_t height) {
 	int16_t ix, iy;
 	uint8_t *data, *dp;
 
+	zoo_video_flush(state);
+
 	if (state->d_video->func_store_display != NULL) {
 		return state->d_video->func_store_display(state->d_video, x, y, width, height);
 	} else if (state->d_video->func_read != NULL) {
 		data = malloc(width * height * 2);
+		ZOO_METRICS_ADD(state, mallocs, 1);
 		if (data != NULL) {
 			// if null, assume nop route - this way out of memory isn't fatal
 			dp = data;
@@ -105,6 +205,8 @@ void zoo_restore_display(zoo_state *state, void *data, int16_t width, int16_t he
 	int16_t ix, iy;
 	uint8_t *data8;
 
+	zoo_video_flush(state);
+
 	if (state->d_video->func_restore_display != NULL) {
 		return state->d_video->func_restore_display(state->d_video, data, width, height, srcx, srcy, srcwidth, srcheight, dstx, dsty);
 	} else if (data != NULL && state->d_video->func_write != NULL) {
@@ -120,6 +222,7 @@ void zoo_restore_display(zoo_state *state, void *data, int16_t width, int16_t he
 				zoo_board_draw_tile(state, dstx + ix, dsty + iy);
 			}
 		}
+		zoo_video_flush(state);
 	}
 }
 
@@ -149,12 +252,15 @@ void zoo_state_init(zoo_state *state) {
 	state->func_draw_sidebar = zoo_default_draw_sidebar;
 
 	state->tick_speed = 4;
+	state->oop_ins_limit = 32;
 
 	zoo_sound_state_init(&(state->sound));
 
 	state->input.repeat_start = 4;
 	state->input.repeat_end = 6;
 
+	zoo_window_set_position(state, 5, 3, 49, 19);
+
 	zoo_world_create(state);
 	zoo_game_start(state, GS_TITLE);
 }
@@ -199,5 +305,6 @@ int16_t zoo_hsecs_to_pit_ticks(int16_t hsecs) {
 
 void zoo_redraw(zoo_state *state) {
 	zoo_board_draw(state);
+	zoo_video_flush(state);
 	state->func_draw_sidebar(state, ZOO_SIDEBAR_UPDATE_ALL_REDRAW);
 }
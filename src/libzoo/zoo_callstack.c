@@ -31,6 +31,9 @@ zoo_call *zoo_call_push(zoo_call_stack *stack, zoo_call_type type, uint8_t state
 	if (new_call == NULL) {
 		return NULL;
 	}
+#ifdef ZOO_METRICS
+	stack->metrics_pushes++;
+#endif
 	new_call->next = stack->call;
 	new_call->type = type;
 	new_call->state = state;
@@ -62,11 +62,11 @@ static void zoo_e_message_timer_tick(zoo_state *state, int16_t stat_id) {
 		} else if (state->d_video->func_write != NULL) {
 			ix = strnlen(state->board.info.message, ZOO_LEN_MESSAGE);
 			col = 9 + (stat->p2 % 7);
-			state->d_video->func_write(state->d_video, ((60 - ix) >> 1), 24, col, ' ');
+			zoo_video_write(state, ((60 - ix) >> 1), 24, col, ' ');
 			for (i = 0; i < ix; i++) {
-				state->d_video->func_write(state->d_video, ((60 - ix) >> 1) + 1 + i, 24, col, state->board.info.message[i]);
+				zoo_video_write(state, ((60 - ix) >> 1) + 1 + i, 24, col, state->board.info.message[i]);
 			}
-			state->d_video->func_write(state->d_video, ((60 - ix) >> 1) + 1 + ix, 24, col, ' ');
+			zoo_video_write(state, ((60 - ix) >> 1) + 1 + ix, 24, col, ' ');
 		}
 		stat->p2--;
 		if (stat->p2 <= 0) {
@@ -95,9 +95,9 @@ static void zoo_e_lion_tick(zoo_state *state, int16_t stat_id) {
 		zoo_calc_direction_seek(state, stat->x, stat->y, &dx, &dy);
 	}
 
-	if (zoo_element_defs[state->board.tiles[stat->x + dx][stat->y + dy].element].walkable) {
+	if (zoo_element_defs[ZOO_TILE(&state->board, stat->x + dx, stat->y + dy).element].walkable) {
 		zoo_stat_move(state, stat_id, stat->x + dx, stat->y + dy);
-	} else if (state->board.tiles[stat->x + dx][stat->y + dy].element == ZOO_E_PLAYER) {
+	} else if (ZOO_TILE(&state->board, stat->x + dx, stat->y + dy).element == ZOO_E_PLAYER) {
 		zoo_board_attack_tile(state, stat_id, stat->x + dx, stat->y + dy);
 	}
 }
@@ -142,7 +142,7 @@ static void zoo_e_ruffian_tick(zoo_state *state, int16_t stat_id) {
 			zoo_calc_direction_seek(state, stat->x, stat->y, &stat->step_x, &stat->step_y);
 		}
 
-		d_elem = &state->board.tiles[stat->x + stat->step_x][stat->y + stat->step_y].element;
+		d_elem = &ZOO_TILE(&state->board, stat->x + stat->step_x, stat->y + stat->step_y).element;
 		if (*d_elem == ZOO_E_PLAYER) {
 			zoo_board_attack_tile(state, stat_id, stat->x + stat->step_x, stat->y + stat->step_y);
 		} else if (zoo_element_defs[*d_elem].walkable) {
@@ -182,7 +182,7 @@ static void zoo_e_bear_tick(zoo_state *state, int16_t stat_id) {
 	dy = 0;
 
 Movement:
-	d_elem = &state->board.tiles[stat->x + dx][stat->y + dy].element;
+	d_elem = &ZOO_TILE(&state->board, stat->x + dx, stat->y + dy).element;
 	if (zoo_element_defs[*d_elem].walkable) {
 		zoo_stat_move(state, stat_id, stat->x + dx, stat->y + dy);
 	} else if (*d_elem == ZOO_E_PLAYER || *d_elem == ZOO_E_BREAKABLE) {
@@ -207,8 +207,8 @@ static void zoo_e_centipede_head_tick(zoo_state *state, int16_t stat_id) {
 		zoo_calc_direction_rnd(state, &stat->step_x, &stat->step_y);
 	}
 
-	if (!zoo_element_defs[state->board.tiles[stat->x + stat->step_x][stat->y + stat->step_y].element].walkable
-		&& (state->board.tiles[stat->x + stat->step_x][stat->y + stat->step_y].element != ZOO_E_PLAYER))
+	if (!zoo_element_defs[ZOO_TILE(&state->board, stat->x + stat->step_x, stat->y + stat->step_y).element].walkable
+		&& (ZOO_TILE(&state->board, stat->x + stat->step_x, stat->y + stat->step_y).element != ZOO_E_PLAYER))
 	{
 		ix = stat->step_x;
 		iy = stat->step_y;
@@ -217,17 +217,17 @@ static void zoo_e_centipede_head_tick(zoo_state *state, int16_t stat_id) {
 		stat->step_y = ((state->func_random(state, 2) * 2) - 1) * stat->step_x;
 		stat->step_x = tmp;
 
-		if (!zoo_element_defs[state->board.tiles[stat->x + stat->step_x][stat->y + stat->step_y].element].walkable
-			&& (state->board.tiles[stat->x + stat->step_x][stat->y + stat->step_y].element != ZOO_E_PLAYER))
+		if (!zoo_element_defs[ZOO_TILE(&state->board, stat->x + stat->step_x, stat->y + stat->step_y).element].walkable
+			&& (ZOO_TILE(&state->board, stat->x + stat->step_x, stat->y + stat->step_y).element != ZOO_E_PLAYER))
 		{
 			stat->step_x = -stat->step_x;
 			stat->step_y = -stat->step_y;
 
-			if (!zoo_element_defs[state->board.tiles[stat->x + stat->step_x][stat->y + stat->step_y].element].walkable
-				&& (state->board.tiles[stat->x + stat->step_x][stat->y + stat->step_y].element != ZOO_E_PLAYER))
+			if (!zoo_element_defs[ZOO_TILE(&state->board, stat->x + stat->step_x, stat->y + stat->step_y).element].walkable
+				&& (ZOO_TILE(&state->board, stat->x + stat->step_x, stat->y + stat->step_y).element != ZOO_E_PLAYER))
 			{
-				if (zoo_element_defs[state->board.tiles[stat->x - ix][stat->y - iy].element].walkable
-					|| (state->board.tiles[stat->x - ix][stat->y - iy].element == ZOO_E_PLAYER))
+				if (zoo_element_defs[ZOO_TILE(&state->board, stat->x - ix, stat->y - iy).element].walkable
+					|| (ZOO_TILE(&state->board, stat->x - ix, stat->y - iy).element == ZOO_E_PLAYER))
 				{
 					stat->step_x = -ix;
 					stat->step_y = -iy;
@@ -241,7 +241,7 @@ static void zoo_e_centipede_head_tick(zoo_state *state, int16_t stat_id) {
 
 	if ((stat->step_x == 0) && (stat->step_y == 0)) {
 		// flip centipede
-		state->board.tiles[stat->x][stat->y].element = ZOO_E_CENTIPEDE_SEGMENT;
+		zoo_board_set_element(&state->board, stat->x, stat->y, ZOO_E_CENTIPEDE_SEGMENT);
 		stat->leader = -1;
 		while (stat->follower > 0) {
 			tmp = stat->follower;
@@ -252,12 +252,12 @@ static void zoo_e_centipede_head_tick(zoo_state *state, int16_t stat_id) {
 			stat = &(state->board.stats[stat_id]);
 		}
 		stat->follower = stat->leader;
-		state->board.tiles[stat->x][stat->y].element = ZOO_E_CENTIPEDE_HEAD;
-	} else if (state->board.tiles[stat->x + stat->step_x][stat->y + stat->step_y].element == ZOO_E_PLAYER) {
+		zoo_board_set_element(&state->board, stat->x, stat->y, ZOO_E_CENTIPEDE_HEAD);
+	} else if (ZOO_TILE(&state->board, stat->x + stat->step_x, stat->y + stat->step_y).element == ZOO_E_PLAYER) {
 		// attack player
 		if (stat->follower != -1) {
 			stat2 = &(state->board.stats[stat->follower]);
-			state->board.tiles[stat2->x][stat2->y].element = ZOO_E_CENTIPEDE_HEAD;
+			zoo_board_set_element(&state->board, stat2->x, stat2->y, ZOO_E_CENTIPEDE_HEAD);
 			stat2->step_x = stat->step_x;
 			stat2->step_y = stat->step_y;
 			zoo_board_draw_tile(state, stat2->x, stat2->y);
@@ -274,17 +274,17 @@ static void zoo_e_centipede_head_tick(zoo_state *state, int16_t stat_id) {
 			iy = stat->step_y;
 
 			if (stat->follower < 0) {
-				if (state->board.tiles[tx - ix][ty - iy].element == ZOO_E_CENTIPEDE_SEGMENT) {
+				if (ZOO_TILE(&state->board, tx - ix, ty - iy).element == ZOO_E_CENTIPEDE_SEGMENT) {
 					tmp = zoo_stat_get_id(state, tx - ix, ty - iy);
 					if (tmp >= 0 && state->board.stats[tmp].leader < 0) {
 						stat->follower = tmp;
 					}
-				} else if (state->board.tiles[tx - iy][ty - ix].element == ZOO_E_CENTIPEDE_SEGMENT) {
+				} else if (ZOO_TILE(&state->board, tx - iy, ty - ix).element == ZOO_E_CENTIPEDE_SEGMENT) {
 					tmp = zoo_stat_get_id(state, tx - iy, ty - ix);
 					if (tmp >= 0 && state->board.stats[tmp].leader < 0) {
 						stat->follower = tmp;
 					}
-				} else if (state->board.tiles[tx + iy][ty + ix].element == ZOO_E_CENTIPEDE_SEGMENT) {
+				} else if (ZOO_TILE(&state->board, tx + iy, ty + ix).element == ZOO_E_CENTIPEDE_SEGMENT) {
 					tmp = zoo_stat_get_id(state, tx + iy, ty + ix);
 					if (tmp >= 0 && state->board.stats[tmp].leader < 0) {
 						stat->follower = tmp;
@@ -311,7 +311,7 @@ static void zoo_e_centipede_segment_tick(zoo_state *state, int16_t stat_id) {
 
 	if (stat->leader < 0) {
 		if (stat->leader < -1) {
-			state->board.tiles[stat->x][stat->y].element = ZOO_E_CENTIPEDE_HEAD;
+			zoo_board_set_element(&state->board, stat->x, stat->y, ZOO_E_CENTIPEDE_HEAD);
 		} else {
 			stat->leader -= 1;
 		}
@@ -328,7 +328,7 @@ static void zoo_e_bullet_tick(zoo_state *state, int16_t stat_id) {
 TryMove:
 	ix = stat->x + stat->step_x;
 	iy = stat->y + stat->step_y;
-	i_elem = state->board.tiles[ix][iy].element;
+	i_elem = ZOO_TILE(&state->board, ix, iy).element;
 
 	if (zoo_element_defs[i_elem].walkable || i_elem == ZOO_E_WATER) {
 		zoo_stat_move(state, stat_id, ix, iy);
@@ -352,7 +352,7 @@ TryMove:
 		return;
 	}
 
-	if (state->board.tiles[stat->x + stat->step_y][stat->y + stat->step_x].element == ZOO_E_RICOCHET && first_try) {
+	if (ZOO_TILE(&state->board, stat->x + stat->step_y, stat->y + stat->step_x).element == ZOO_E_RICOCHET && first_try) {
 		ix = stat->step_x;
 		stat->step_x = -stat->step_y;
 		stat->step_y = -ix;
@@ -361,7 +361,7 @@ TryMove:
 		goto TryMove;
 	}
 
-	if (state->board.tiles[stat->x - stat->step_y][stat->y - stat->step_x].element == ZOO_E_RICOCHET && first_try) {
+	if (ZOO_TILE(&state->board, stat->x - stat->step_y, stat->y - stat->step_x).element == ZOO_E_RICOCHET && first_try) {
 		ix = stat->step_x;
 		stat->step_x = stat->step_y;
 		stat->step_y = ix;
@@ -391,7 +391,7 @@ static void zoo_e_line_draw(zoo_state *state, int16_t x, int16_t y, uint8_t *ch)
 	int16_t i, v = 0, shift = 1;
 
 	for (i = 0; i < 4; i++, shift <<= 1) {
-		switch (state->board.tiles[x + zoo_neighbor_delta_x[i]][y + zoo_neighbor_delta_y[i]].element) {
+		switch (ZOO_TILE(&state->board, x + zoo_neighbor_delta_x[i], y + zoo_neighbor_delta_y[i]).element) {
 			case ZOO_E_LINE:
 			case ZOO_E_BOARD_EDGE:
 				v |= shift;
@@ -446,7 +446,7 @@ static void zoo_conveyor_tick(zoo_state *state, int16_t x, int16_t y, int16_t di
 
 	can_move = true;
 	for (i = i_min; i != i_max; i += dir) {
-		tiles[i] = state->board.tiles[x + zoo_diagonal_delta_x[i]][y + zoo_diagonal_delta_y[i]];
+		tiles[i] = ZOO_TILE(&state->board, x + zoo_diagonal_delta_x[i], y + zoo_diagonal_delta_y[i]);
 		if (tiles[i].element == ZOO_E_EMPTY) {
 			can_move = true;
 		} else if (!zoo_element_defs[tiles[i].element].pushable) {
@@ -460,19 +460,19 @@ static void zoo_conveyor_tick(zoo_state *state, int16_t x, int16_t y, int16_t di
 				ix = x + zoo_diagonal_delta_x[(i - dir) & 7];
 				iy = y + zoo_diagonal_delta_y[(i - dir) & 7];
 				if (zoo_element_defs[tiles[i].element].cycle >= 0) {
-					tmp_tile = state->board.tiles[x + zoo_diagonal_delta_x[i]][y + zoo_diagonal_delta_y[i]];
+					tmp_tile = ZOO_TILE(&state->board, x + zoo_diagonal_delta_x[i], y + zoo_diagonal_delta_y[i]);
 					i_stat = zoo_stat_get_id(state, x + zoo_diagonal_delta_x[i], y + zoo_diagonal_delta_y[i]);
-					state->board.tiles[x + zoo_diagonal_delta_x[i]][y + zoo_diagonal_delta_y[i]] = tiles[i];
-					state->board.tiles[ix][iy].element = ZOO_E_EMPTY;
+					zoo_board_set_tile(&state->board, x + zoo_diagonal_delta_x[i], y + zoo_diagonal_delta_y[i], tiles[i]);
+					zoo_board_set_element(&state->board, ix, iy, ZOO_E_EMPTY);
 					zoo_stat_move(state, i_stat, ix, iy);
-					state->board.tiles[x + zoo_diagonal_delta_x[i]][y + zoo_diagonal_delta_y[i]] = tmp_tile;
+					zoo_board_set_tile(&state->board, x + zoo_diagonal_delta_x[i], y + zoo_diagonal_delta_y[i], tmp_tile);
 				} else {
-					state->board.tiles[ix][iy] = tiles[i];
+					zoo_board_set_tile(&state->board, ix, iy, tiles[i]);
 					zoo_board_draw_tile(state, ix, iy);
 				}
 
 				if (!zoo_element_defs[tiles[(i + dir) & 7].element].pushable) {
-					state->board.tiles[x + zoo_diagonal_delta_x[i]][y + zoo_diagonal_delta_y[i]].element = ZOO_E_EMPTY;
+					zoo_board_set_element(&state->board, x + zoo_diagonal_delta_x[i], y + zoo_diagonal_delta_y[i], ZOO_E_EMPTY);
 					zoo_board_draw_tile(state, x + zoo_diagonal_delta_x[i], y + zoo_diagonal_delta_y[i]);
 				}
 			} else {
@@ -583,7 +583,7 @@ static void zoo_e_transporter_move(zoo_state *state, int16_t x, int16_t y, int16
 		do {
 			ix += dx;
 			iy += dy;
-			ielem = &state->board.tiles[ix][iy].element;
+			ielem = &ZOO_TILE(&state->board, ix, iy).element;
 			if (*ielem == ZOO_E_BOARD_EDGE) {
 				finish_search = true;
 			} else if (is_valid_dest) {
@@ -647,11 +647,10 @@ static void zoo_e_transporter_draw(zoo_state *state, int16_t x, int16_t y, uint8
 static const char *zoo_e_star_chars = "\xB3\x2F\xC4\x5C";
 
 static void zoo_e_star_draw(zoo_state *state, int16_t x, int16_t y, uint8_t *ch) {
-	uint8_t *col = &state->board.tiles[x][y].color;
+	uint8_t col = ZOO_TILE(&state->board, x, y).color + 1;
 
 	*ch = zoo_e_star_chars[state->current_tick & 3];
-	*col += 1;
-	if (*col > 15) *col = 9;
+	zoo_board_set_color(&state->board, x, y, col > 15 ? 9 : col);
 }
 
 static void zoo_e_star_tick(zoo_state *state, int16_t stat_id) {
@@ -664,7 +663,7 @@ static void zoo_e_star_tick(zoo_state *state, int16_t stat_id) {
 	} else {
 		if ((stat->p2 & 1) == 0) {
 			zoo_calc_direction_seek(state, stat->x, stat->y, &stat->step_x, &stat->step_y);
-			i_elem = &state->board.tiles[stat->x + stat->step_x][stat->y + stat->step_y].element;
+			i_elem = &ZOO_TILE(&state->board, stat->x + stat->step_x, stat->y + stat->step_y).element;
 			if (*i_elem == ZOO_E_PLAYER || *i_elem == ZOO_E_BREAKABLE) {
 				zoo_board_attack_tile(state, stat_id, stat->x + stat->step_x, stat->y + stat->step_y);
 			} else {
@@ -692,7 +691,7 @@ static void zoo_e_energizer_touch(zoo_state *state, int16_t x, int16_t y, int16_
 		"\x30\x03\x23\x03\x24\x03\x25\x03\x35\x03\x25\x03\x23\x03\x20\x03"
 		"\x30\x03\x23\x03\x24\x03\x25\x03\x35\x03\x25\x03\x23\x03\x20\x03");
 
-	state->board.tiles[x][y].element = ZOO_E_EMPTY;
+	zoo_board_set_element(&state->board, x, y, ZOO_E_EMPTY);
 	zoo_board_draw_tile(state, x, y);
 
 	state->world.info.energizer_ticks = 75;
@@ -714,21 +713,21 @@ static void zoo_e_slime_tick(zoo_state *state, int16_t stat_id) {
 	if (stat->p1 < stat->p2) {
 		stat->p1++;
 	} else {
-		color = state->board.tiles[stat->x][stat->y].color;
+		color = ZOO_TILE(&state->board, stat->x, stat->y).color;
 		stat->p1 = 0;
 		start_x = stat->x;
 		start_y = stat->y;
 		changed_tiles = 0;
 
 		for (dir = 0; dir < 4; dir++) {
-			if (zoo_element_defs[state->board.tiles
-				[start_x + zoo_neighbor_delta_x[dir]]
-				[start_y + zoo_neighbor_delta_y[dir]]
+			if (zoo_element_defs[ZOO_TILE(&state->board,
+				start_x + zoo_neighbor_delta_x[dir],
+				start_y + zoo_neighbor_delta_y[dir])
 			.element].walkable) {
 				if (changed_tiles == 0) {
 					zoo_stat_move(state, stat_id, start_x + zoo_neighbor_delta_x[dir], start_y + zoo_neighbor_delta_y[dir]);
-					state->board.tiles[start_x][start_y].element = ZOO_E_BREAKABLE;
-					state->board.tiles[start_x][start_y].color = color;
+					zoo_board_set_element(&state->board, start_x, start_y, ZOO_E_BREAKABLE);
+					zoo_board_set_color(&state->board, start_x, start_y, color);
 					zoo_board_draw_tile(state, start_x, start_y);
 				} else {
 					zoo_stat_add(state, start_x + zoo_neighbor_delta_x[dir], start_y + zoo_neighbor_delta_y[dir],
@@ -741,18 +740,18 @@ static void zoo_e_slime_tick(zoo_state *state, int16_t stat_id) {
 
 		if (changed_tiles == 0) {
 			zoo_stat_remove(state, stat_id);
-			state->board.tiles[start_x][start_y].element = ZOO_E_BREAKABLE;
-			state->board.tiles[start_x][start_y].color = color;
+			zoo_board_set_element(&state->board, start_x, start_y, ZOO_E_BREAKABLE);
+			zoo_board_set_color(&state->board, start_x, start_y, color);
 			zoo_board_draw_tile(state, start_x, start_y);
 		}
 	}
 }
 
 static void zoo_e_slime_touch(zoo_state *state, int16_t x, int16_t y, int16_t source_stat_id, int16_t *dx, int16_t *dy) {
-	uint8_t color = state->board.tiles[x][y].color;
+	uint8_t color = ZOO_TILE(&state->board, x, y).color;
 	zoo_board_damage_stat(state, zoo_stat_get_id(state, x, y));
-	state->board.tiles[x][y].element = ZOO_E_BREAKABLE;
-	state->board.tiles[x][y].color = color;
+	zoo_board_set_element(&state->board, x, y, ZOO_E_BREAKABLE);
+	zoo_board_set_color(&state->board, x, y, color);
 	zoo_board_draw_tile(state, x, y);
 	zoo_sound_queue_const(&(state->sound), 2, "\x20\x01\x23\x01");
 }
@@ -767,7 +766,7 @@ static void zoo_e_shark_tick(zoo_state *state, int16_t stat_id) {
 		zoo_calc_direction_seek(state, stat->x, stat->y, &dx, &dy);
 	}
 
-	switch (state->board.tiles[stat->x + dx][stat->y + dy].element) {
+	switch (ZOO_TILE(&state->board, stat->x + dx, stat->y + dy).element) {
 		case ZOO_E_WATER: {
 			zoo_stat_move(state, stat_id, stat->x + dx, stat->y + dy);
 		} break;
@@ -799,10 +798,10 @@ static void zoo_e_blink_wall_tick(zoo_state *state, int16_t stat_id) {
 
 		el = (stat->step_x != 0) ? ZOO_E_BLINK_RAY_EW : ZOO_E_BLINK_RAY_NS;
 
-		while (state->board.tiles[ix][iy].element == el
-			&& state->board.tiles[ix][iy].color == state->board.tiles[stat->x][stat->y].color)
+		while (ZOO_TILE(&state->board, ix, iy).element == el
+			&& ZOO_TILE(&state->board, ix, iy).color == ZOO_TILE(&state->board, stat->x, stat->y).color)
 		{
-			state->board.tiles[ix][iy].element = ZOO_E_EMPTY;
+			zoo_board_set_element(&state->board, ix, iy, ZOO_E_EMPTY);
 			zoo_board_draw_tile(state, ix, iy);
 			ix += stat->step_x;
 			iy += stat->step_y;
@@ -812,7 +811,7 @@ static void zoo_e_blink_wall_tick(zoo_state *state, int16_t stat_id) {
 		if ((stat->x + stat->step_x) == ix && (stat->y + stat->step_y) == iy) {
 			hit_boundary = false;
 			do {
-				i_elem = &(state->board.tiles[ix][iy].element);
+				i_elem = &(ZOO_TILE(&state->board, ix, iy).element);
 				if (*i_elem != ZOO_E_EMPTY && zoo_element_defs[*i_elem].destructible) {
 					zoo_board_damage_tile(state, ix, iy);
 				}
@@ -821,15 +820,15 @@ static void zoo_e_blink_wall_tick(zoo_state *state, int16_t stat_id) {
 					player_stat_id = zoo_stat_get_id(state, ix, iy);
 
 					if (stat->step_x != 0) {
-						if (state->board.tiles[ix][iy - 1].element == ZOO_E_EMPTY) {
+						if (ZOO_TILE(&state->board, ix, iy - 1).element == ZOO_E_EMPTY) {
 							zoo_stat_move(state, player_stat_id, ix, iy - 1);
-						} else if (state->board.tiles[ix][iy + 1].element == ZOO_E_EMPTY) {
+						} else if (ZOO_TILE(&state->board, ix, iy + 1).element == ZOO_E_EMPTY) {
 							zoo_stat_move(state, player_stat_id, ix, iy + 1);
 						}
 					} else {
-						if (state->board.tiles[ix + 1][iy].element == ZOO_E_EMPTY) {
+						if (ZOO_TILE(&state->board, ix + 1, iy).element == ZOO_E_EMPTY) {
 							zoo_stat_move(state, player_stat_id, ix + 1, iy);
-						} else if (state->board.tiles[ix - 1][iy].element == ZOO_E_EMPTY) {
+						} else if (ZOO_TILE(&state->board, ix - 1, iy).element == ZOO_E_EMPTY) {
 							zoo_stat_move(state, player_stat_id, ix + 1, iy);
 						}
 					}
@@ -843,8 +842,8 @@ static void zoo_e_blink_wall_tick(zoo_state *state, int16_t stat_id) {
 				}
 
 				if (*i_elem == ZOO_E_EMPTY) {
-					state->board.tiles[ix][iy].element = el;
-					state->board.tiles[ix][iy].color = state->board.tiles[stat->x][stat->y].color;
+					zoo_board_set_element(&state->board, ix, iy, el);
+					zoo_board_set_color(&state->board, ix, iy, ZOO_TILE(&state->board, stat->x, stat->y).color);
 					zoo_board_draw_tile(state, ix, iy);
 				} else {
 					hit_boundary = true;
@@ -866,9 +865,9 @@ void zoo_element_move(zoo_state *state, int16_t old_x, int16_t old_y, int16_t ne
 	if (stat_id >= 0) {
 		zoo_stat_move(state, stat_id, new_x, new_y);
 	} else {
-		state->board.tiles[new_x][new_y] = state->board.tiles[old_x][old_y];
+		zoo_board_set_tile(&state->board, new_x, new_y, ZOO_TILE(&state->board, old_x, old_y));
 		zoo_board_draw_tile(state, new_x, new_y);
-		state->board.tiles[old_x][old_y].element = ZOO_E_EMPTY;
+		zoo_board_set_element(&state->board, old_x, old_y, ZOO_E_EMPTY);
 		zoo_board_draw_tile(state, old_x, old_y);
 	}
 }
@@ -876,11 +875,11 @@ void zoo_element_move(zoo_state *state, int16_t old_x, int16_t old_y, int16_t ne
 void zoo_element_push(zoo_state *state, int16_t x, int16_t y, int16_t dx, int16_t dy) {
 	uint8_t *e, *de;
 
-	e = &state->board.tiles[x][y].element;
+	e = &ZOO_TILE(&state->board, x, y).element;
 	if ((*e == ZOO_E_SLIDER_NS && dx == 0) || (*e == ZOO_E_SLIDER_EW && dy == 0)
 		|| zoo_element_defs[*e].pushable)
 	{
-		de = &state->board.tiles[x+dx][y+dy].element;
+		de = &ZOO_TILE(&state->board, x+dx, y+dy).element;
 		if (*de == ZOO_E_TRANSPORTER) {
 			zoo_e_transporter_move(state, x, y, dx, dy);
 		} else if (*de != ZOO_E_EMPTY) {
@@ -934,7 +933,7 @@ static void zoo_e_object_tick(zoo_state *state, int16_t stat_id) {
 	}
 
 	if (stat->step_x != 0 || stat->step_y != 0) {
-		if (zoo_element_defs[state->board.tiles[stat->x + stat->step_x][stat->y + stat->step_y].element].walkable) {
+		if (zoo_element_defs[ZOO_TILE(&state->board, stat->x + stat->step_x, stat->y + stat->step_y).element].walkable) {
 			zoo_stat_move(state, stat_id, stat->x + stat->step_x, stat->y + stat->step_y);
 		} else {
 			zoo_oop_send(state, -stat_id, "THUD", false);
@@ -967,7 +966,7 @@ static void zoo_e_duplicator_tick(zoo_state *state, int16_t stat_id) {
 		stat->p1++;
 	} else {
 		stat->p1 = 0;
-		target_tile = &state->board.tiles[stat->x - stat->step_x][stat->y - stat->step_y];
+		target_tile = &ZOO_TILE(&state->board, stat->x - stat->step_x, stat->y - stat->step_y);
 		if (target_tile->element == ZOO_E_PLAYER) {
 			// push self
 			call = zoo_call_push(&state->call_stack, TICK_FUNC, 1);
@@ -975,7 +974,7 @@ static void zoo_e_duplicator_tick(zoo_state *state, int16_t stat_id) {
 			call->args.tick.func = zoo_e_duplicator_tick;
 			call->args.tick.stat_id = stat_id;
 			// touch
-			zoo_element_defs[state->board.tiles[stat->x + stat->step_x][stat->y + stat->step_y].element]
+			zoo_element_defs[ZOO_TILE(&state->board, stat->x + stat->step_x, stat->y + stat->step_y).element]
 				.touch_func(state, stat->x + stat->step_x, stat->y + stat->step_y,
 					0, &state->input.delta_x, &state->input.delta_y);
 			// return
@@ -993,14 +992,15 @@ static void zoo_e_duplicator_tick(zoo_state *state, int16_t stat_id) {
 				if (source_stat_id > 0) {
 					if (state->board.stat_count < ((ZOO_MAX_STAT > 174) ? ZOO_MAX_STAT : 174)) {
 						zoo_stat_add(state, stat->x - stat->step_x, stat->y - stat->step_y,
-							state->board.tiles[stat->x + stat->step_x][stat->y + stat->step_y].element,
-							state->board.tiles[stat->x + stat->step_x][stat->y + stat->step_y].color,
+							ZOO_TILE(&state->board, stat->x + stat->step_x, stat->y + stat->step_y).element,
+							ZOO_TILE(&state->board, stat->x + stat->step_x, stat->y + stat->step_y).color,
 							source_stat->cycle, source_stat);
 
 						zoo_board_draw_tile(state, stat->x - stat->step_x, stat->y - stat->step_y);
 					}
 				} else if (source_stat_id != 0) {
-					*target_tile = state->board.tiles[stat->x + stat->step_x][stat->y + stat->step_y];
+					zoo_board_set_tile(&state->board, stat->x - stat->step_x, stat->y - stat->step_y,
+						ZOO_TILE(&state->board, stat->x + stat->step_x, stat->y + stat->step_y));
 					zoo_board_draw_tile(state, stat->x - stat->step_x, stat->y - stat->step_y);
 				}
 
@@ -1015,15 +1015,14 @@ DuplicatorTickState1:
 	}
 
 	zoo_board_draw_tile(state, stat->x, stat->y);
-	stat->cycle = (9 - stat->p2) * 3;
+	zoo_stat_set_cycle(state, stat_id, (9 - stat->p2) * 3);
 }
 
 static void zoo_e_scroll_tick(zoo_state *state, int16_t stat_id) {
 	TICK_GET_SELF;
-	uint8_t *col = &state->board.tiles[stat->x][stat->y].color;
+	uint8_t col = ZOO_TILE(&state->board, stat->x, stat->y).color + 1;
 
-	*col += 1;
-	if (*col > 15) *col = 9;
+	zoo_board_set_color(&state->board, stat->x, stat->y, col > 15 ? 9 : col);
 	zoo_board_draw_tile(state, stat->x, stat->y);
 }
 
@@ -1075,7 +1074,7 @@ ScrollTouchState1:
 
 static void zoo_e_key_touch(zoo_state *state, int16_t x, int16_t y, int16_t source_stat_id, int16_t *dx, int16_t *dy) {
 	char msg[ZOO_LEN_MESSAGE + 1];
-	int16_t key = state->board.tiles[x][y].color & 7;
+	int16_t key = ZOO_TILE(&state->board, x, y).color & 7;
 
 	if (ZOO_IS_KEY_SET(key)) {
 		strncpy(msg, "You already have a ", ZOO_LEN_MESSAGE);
@@ -1085,7 +1084,7 @@ static void zoo_e_key_touch(zoo_state *state, int16_t x, int16_t y, int16_t sour
 		zoo_sound_queue_const(&(state->sound), 2, "\x30\x02\x20\x02");
 	} else {
 		ZOO_SET_KEY(key);
-		state->board.tiles[x][y].element = ZOO_E_EMPTY;
+		zoo_board_set_element(&state->board, x, y, ZOO_E_EMPTY);
 		state->func_draw_sidebar(state, ZOO_SIDEBAR_UPDATE_KEYS);
 		strncpy(msg, "You now have the ", ZOO_LEN_MESSAGE);
 		strncat(msg, zoo_color_names[key], ZOO_LEN_MESSAGE);
@@ -1098,7 +1097,7 @@ static void zoo_e_key_touch(zoo_state *state, int16_t x, int16_t y, int16_t sour
 static void zoo_e_ammo_touch(zoo_state *state, int16_t x, int16_t y, int16_t source_stat_id, int16_t *dx, int16_t *dy) {
 	state->world.info.ammo += 5;
 
-	state->board.tiles[x][y].element = ZOO_E_EMPTY;
+	zoo_board_set_element(&state->board, x, y, ZOO_E_EMPTY);
 	state->func_draw_sidebar(state, ZOO_SIDEBAR_UPDATE_AMMO);
 	zoo_sound_queue_const(&(state->sound), 2, "\x30\x01\x31\x01\x32\x01");
 
@@ -1113,7 +1112,7 @@ static void zoo_e_gem_touch(zoo_state *state, int16_t x, int16_t y, int16_t sour
 	state->world.info.health += 1;
 	state->world.info.score += 10;
 
-	state->board.tiles[x][y].element = ZOO_E_EMPTY;
+	zoo_board_set_element(&state->board, x, y, ZOO_E_EMPTY);
 	if (state->world.info.health < 0) {
 		state->world.info.health = 0;
 	}
@@ -1134,10 +1133,10 @@ static void zoo_e_passage_touch(zoo_state *state, int16_t x, int16_t y, int16_t
 
 static void zoo_e_door_touch(zoo_state *state, int16_t x, int16_t y, int16_t source_stat_id, int16_t *dx, int16_t *dy) {
 	char msg[ZOO_LEN_MESSAGE + 1];
-	int16_t key = (state->board.tiles[x][y].color >> 4) & 7;
+	int16_t key = (ZOO_TILE(&state->board, x, y).color >> 4) & 7;
 
 	if (ZOO_IS_KEY_SET(key)) {
-		state->board.tiles[x][y].element = ZOO_E_EMPTY;
+		zoo_board_set_element(&state->board, x, y, ZOO_E_EMPTY);
 		zoo_board_draw_tile(state, x, y);
 
 		ZOO_CLEAR_KEY(key);
@@ -1186,18 +1185,18 @@ static void zoo_e_pusher_tick(zoo_state *state, int16_t stat_id) {
 
 	start_x = stat->x;
 	start_y = stat->y;
-	if (!zoo_element_defs[state->board.tiles[stat->x + stat->step_x][stat->y + stat->step_y].element].walkable) {
+	if (!zoo_element_defs[ZOO_TILE(&state->board, stat->x + stat->step_x, stat->y + stat->step_y).element].walkable) {
 		zoo_element_push(state, stat->x + stat->step_x, stat->y + stat->step_y, stat->step_x, stat->step_y);
 	}
 
 	stat = zoo_stat_get(state, start_x, start_y, &stat_id);
 	// FIX: bounds check
 	if (stat != NULL) {
-		if (zoo_element_defs[state->board.tiles[stat->x + stat->step_x][stat->y + stat->step_y].element].walkable) {
+		if (zoo_element_defs[ZOO_TILE(&state->board, stat->x + stat->step_x, stat->y + stat->step_y).element].walkable) {
 			zoo_stat_move(state, stat_id, stat->x + stat->step_x, stat->y + stat->step_y);
 			zoo_sound_queue_const(&(state->sound), 2, "\x15\x01");
 
-			if (state->board.tiles[stat->x - (stat->step_x * 2)][stat->y - (stat->step_y * 2)].element == ZOO_E_PUSHER) {
+			if (ZOO_TILE(&state->board, stat->x - (stat->step_x * 2), stat->y - (stat->step_y * 2)).element == ZOO_E_PUSHER) {
 				n_stat = zoo_stat_get(state, stat->x - (stat->step_x * 2), stat->y - (stat->step_y * 2), &n_stat_id);
 				// FIX: bounds check
 				if (n_stat != NULL && n_stat->step_x == stat->step_x && n_stat->step_y == stat->step_y) {
@@ -1210,7 +1209,7 @@ static void zoo_e_pusher_tick(zoo_state *state, int16_t stat_id) {
 
 static void zoo_e_torch_touch(zoo_state *state, int16_t x, int16_t y, int16_t source_stat_id, int16_t *dx, int16_t *dy) {
 	state->world.info.torches += 1;
-	state->board.tiles[x][y].element = ZOO_E_EMPTY;
+	zoo_board_set_element(&state->board, x, y, ZOO_E_EMPTY);
 
 	zoo_board_draw_tile(state, x, y);
 	state->func_draw_sidebar(state, ZOO_SIDEBAR_UPDATE_TORCHES);
@@ -1224,7 +1223,7 @@ static void zoo_e_torch_touch(zoo_state *state, int16_t x, int16_t y, int16_t so
 }
 
 static void zoo_e_invisible_touch(zoo_state *state, int16_t x, int16_t y, int16_t source_stat_id, int16_t *dx, int16_t *dy) {
-	state->board.tiles[x][y].element = ZOO_E_NORMAL;
+	zoo_board_set_element(&state->board, x, y, ZOO_E_NORMAL);
 	zoo_board_draw_tile(state, x, y);
 
 	zoo_sound_queue_const(&(state->sound), 3, "\x12\x01\x10\x01");
@@ -1232,7 +1231,7 @@ static void zoo_e_invisible_touch(zoo_state *state, int16_t x, int16_t y, int16_
 }
 
 static void zoo_e_forest_touch(zoo_state *state, int16_t x, int16_t y, int16_t source_stat_id, int16_t *dx, int16_t *dy) {
-	state->board.tiles[x][y].element = ZOO_E_EMPTY;
+	zoo_board_set_element(&state->board, x, y, ZOO_E_EMPTY);
 	zoo_board_draw_tile(state, x, y);
 
 	zoo_sound_queue_const(&(state->sound), 3, "\x39\x01");
@@ -1287,7 +1286,7 @@ static void zoo_e_board_edge_touch(zoo_state *state, int16_t x, int16_t y, int16
 	if (state->board.info.neighbor_boards[neighbor_id] != 0) {
 		board_id = state->world.info.current_board;
 		zoo_board_change(state, state->board.info.neighbor_boards[neighbor_id]);
-		if (state->board.tiles[entry_x][entry_y].element != ZOO_E_PLAYER) {
+		if (ZOO_TILE(&state->board, entry_x, entry_y).element != ZOO_E_PLAYER) {
 			// push self
 			call = zoo_call_push(&state->call_stack, TOUCH_FUNC, 1);
 			CALL_OOM_CHECK(state, call);
@@ -1298,7 +1297,7 @@ static void zoo_e_board_edge_touch(zoo_state *state, int16_t x, int16_t y, int16
 			call->args.touch.extra.board_edge.entry_x = entry_x;
 			call->args.touch.extra.board_edge.entry_y = entry_y;
 			// touch
-			zoo_element_defs[state->board.tiles[entry_x][entry_y].element]
+			zoo_element_defs[ZOO_TILE(&state->board, entry_x, entry_y).element]
 				.touch_func(state, entry_x, entry_y, source_stat_id,
 					&state->input.delta_x, &state->input.delta_y);
 			// return
@@ -1307,10 +1306,10 @@ static void zoo_e_board_edge_touch(zoo_state *state, int16_t x, int16_t y, int16
 
 BoardEdgeState1:
 		if (
-			zoo_element_defs[state->board.tiles[entry_x][entry_y].element].walkable
-			|| (state->board.tiles[entry_x][entry_y].element == ZOO_E_PLAYER)
+			zoo_element_defs[ZOO_TILE(&state->board, entry_x, entry_y).element].walkable
+			|| (ZOO_TILE(&state->board, entry_x, entry_y).element == ZOO_E_PLAYER)
 		) {
-			if (state->board.tiles[entry_x][entry_y].element != ZOO_E_PLAYER) {
+			if (ZOO_TILE(&state->board, entry_x, entry_y).element != ZOO_E_PLAYER) {
 				zoo_stat_move(state, 0, entry_x, entry_y);
 			}
 
@@ -1340,8 +1339,8 @@ void zoo_draw_player_surroundings(zoo_state *state, int16_t x, int16_t y, int16_
 	for (iy = y - ZOO_TORCH_DY - 1; iy <= y + ZOO_TORCH_DY + 1; iy++)
 	if (iy >= 1 && iy <= ZOO_BOARD_HEIGHT) {
 		if (bomb_phase > 0) {
-			if (zoo_dist_sq2(ix - x, iy - y) < ZOO_TORCH_DSQ) {
-				tile = &state->board.tiles[ix][iy];
+			if (ZOO_TORCH_LIT(ix - x, iy - y)) {
+				tile = &ZOO_TILE(&state->board, ix, iy);
 				if (bomb_phase == 1) {
 					// if (zoo_element_defs[tile->element].param_text_name[0] != '\0') {
 					if (zoo_element_defs[tile->element].has_text) {
@@ -1356,13 +1355,13 @@ void zoo_draw_player_surroundings(zoo_state *state, int16_t x, int16_t y, int16_
 					}
 
 					if (tile->element == ZOO_E_EMPTY || tile->element == ZOO_E_BREAKABLE) {
-						tile->element = ZOO_E_BREAKABLE;
-						tile->color = 9 + state->func_random(state, 7);
+						zoo_board_set_element(&state->board, ix, iy, ZOO_E_BREAKABLE);
+						zoo_board_set_color(&state->board, ix, iy, 9 + state->func_random(state, 7));
 						zoo_board_draw_tile(state, ix, iy);
 					}
 				} else /* usually bomb_phase == 2 */ {
 					if (tile->element == ZOO_E_BREAKABLE) {
-						tile->element = ZOO_E_EMPTY;
+						zoo_board_set_element(&state->board, ix, iy, ZOO_E_EMPTY);
 					}
 				}
 			}
@@ -1393,16 +1392,16 @@ static void zoo_e_player_tick(zoo_state *state, int16_t stat_id) {
 
 	if (state->world.info.energizer_ticks > 0) {
 		if (state->current_tick & 1) {
-			state->board.tiles[stat->x][stat->y].color = 0x0F;
+			zoo_board_set_color(&state->board, stat->x, stat->y, 0x0F);
 		} else {
-			state->board.tiles[stat->x][stat->y].color = (((state->current_tick % 7) + 1) << 4) | 0x0F;
+			zoo_board_set_color(&state->board, stat->x, stat->y, (((state->current_tick % 7) + 1) << 4) | 0x0F);
 		}
 
 		zoo_board_draw_tile(state, stat->x, stat->y);
 	} else if (
-		state->board.tiles[stat->x][stat->y].color != 0x1F
+		ZOO_TILE(&state->board, stat->x, stat->y).color != 0x1F
 	) {
-		state->board.tiles[stat->x][stat->y].color = 0x1F;
+		zoo_board_set_color(&state->board, stat->x, stat->y, 0x1F);
 		zoo_board_draw_tile(state, stat->x, stat->y);
 	}
 
@@ -1435,9 +1434,9 @@ static void zoo_e_player_tick(zoo_state *state, int16_t stat_id) {
 			} else {
 				bullet_count = 0;
 				for (i = 0; i <= state->board.stat_count; i++) {
-					if (state->board.tiles
-						[state->board.stats[i].x]
-						[state->board.stats[i].y]
+					if (ZOO_TILE(&state->board,
+						state->board.stats[i].x,
+						state->board.stats[i].y)
 						.element == ZOO_E_BULLET && state->board.stats[i].p1 == 0
 					) {
 						bullet_count++;
@@ -1464,9 +1463,9 @@ static void zoo_e_player_tick(zoo_state *state, int16_t stat_id) {
 			call->args.tick.func = zoo_e_player_tick;
 			call->args.tick.stat_id = stat_id;
 			// touch
-			zoo_element_defs[state->board.tiles
-				[stat->x + state->input.delta_x]
-				[stat->y + state->input.delta_y]
+			zoo_element_defs[ZOO_TILE(&state->board,
+				stat->x + state->input.delta_x,
+				stat->y + state->input.delta_y)
 			.element].touch_func(state, stat->x + state->input.delta_x, stat->y + state->input.delta_y,
 				0, &state->input.delta_x, &state->input.delta_y);
 			// return
@@ -1481,9 +1480,9 @@ PlayerTickState1:
 		if (state->input.delta_x != 0 || state->input.delta_y != 0) {
 			// TODO player move sound
 			if (
-				zoo_element_defs[state->board.tiles
-					[stat->x + state->input.delta_x]
-					[stat->y + state->input.delta_y]
+				zoo_element_defs[ZOO_TILE(&state->board,
+					stat->x + state->input.delta_x,
+					stat->y + state->input.delta_y)
 				.element].walkable
 			) {
 				zoo_stat_move(state, 0,
@@ -1534,7 +1533,7 @@ PlayerTickState1:
 		if (state->world.info.energizer_ticks == 10) {
 			zoo_sound_queue_const(&(state->sound), 9, "\x20\x03\x1A\x03\x17\x03\x16\x03\x15\x03\x13\x03\x10\x03");
 		} else if (state->world.info.energizer_ticks <= 0) {
-			state->board.tiles[stat->x][stat->y].color = zoo_element_defs[ZOO_E_PLAYER].color;
+			zoo_board_set_color(&state->board, stat->x, stat->y, zoo_element_defs[ZOO_E_PLAYER].color);
 			zoo_board_draw_tile(state, stat->x, stat->y);
 		}
 	}
@@ -46,14 +46,37 @@ const int16_t zoo_diagonal_delta_y[8] = {1, 1, 1, 0, -1, -1, -1, 0};
 const int16_t zoo_neighbor_delta_x[4] = {0, 0, -1, 1};
 const int16_t zoo_neighbor_delta_y[4] = {-1, 1, 0, 0};
 
+// cells lit by a torch, one row per dy; bit (dx + ZOO_TORCH_DX) is set if
+// zoo_dist_sq2(dx, dy) < ZOO_TORCH_DSQ
+#define ZOO_TORCH_BIT(dx, dy) ((zoo_dist_sq2((dx), (dy)) < ZOO_TORCH_DSQ) ? (1UL << ((dx) + ZOO_TORCH_DX)) : 0)
+#define ZOO_TORCH_ROW(dy) ( \
+	ZOO_TORCH_BIT(-8, dy) | ZOO_TORCH_BIT(-7, dy) | ZOO_TORCH_BIT(-6, dy) | ZOO_TORCH_BIT(-5, dy) | \
+	ZOO_TORCH_BIT(-4, dy) | ZOO_TORCH_BIT(-3, dy) | ZOO_TORCH_BIT(-2, dy) | ZOO_TORCH_BIT(-1, dy) | \
+	ZOO_TORCH_BIT(0, dy) | ZOO_TORCH_BIT(1, dy) | ZOO_TORCH_BIT(2, dy) | ZOO_TORCH_BIT(3, dy) | \
+	ZOO_TORCH_BIT(4, dy) | ZOO_TORCH_BIT(5, dy) | ZOO_TORCH_BIT(6, dy) | ZOO_TORCH_BIT(7, dy) | \
+	ZOO_TORCH_BIT(8, dy) \
+)
+
+#if ZOO_TORCH_DX != 8 || ZOO_TORCH_DY != 5
+#error zoo_torch_stencil needs updating for the new torch size
+#endif
+
+const uint32_t zoo_torch_stencil[ZOO_TORCH_DY * 2 + 1] = {
+	ZOO_TORCH_ROW(-5), ZOO_TORCH_ROW(-4), ZOO_TORCH_ROW(-3), ZOO_TORCH_ROW(-2),
+	ZOO_TORCH_ROW(-1), ZOO_TORCH_ROW(0), ZOO_TORCH_ROW(1), ZOO_TORCH_ROW(2),
+	ZOO_TORCH_ROW(3), ZOO_TORCH_ROW(4), ZOO_TORCH_ROW(5)
+};
+
 static const zoo_tile zoo_board_tile_edge = {ZOO_E_BOARD_EDGE, 0x00};
 static const zoo_tile zoo_board_tile_border = {ZOO_E_NORMAL, 0x0E};
+static const zoo_tile zoo_board_tile_empty = {ZOO_E_EMPTY, 0x00};
 
 void zoo_board_change(zoo_state *state, int16_t board_id) {
-	state->board.tiles[state->board.stats[0].x][state->board.stats[0].y].element = ZOO_E_PLAYER;
-	state->board.tiles[state->board.stats[0].x][state->board.stats[0].y].color
-		= zoo_element_defs[ZOO_E_PLAYER].color;
-	
+	zoo_tile player_tile = {ZOO_E_PLAYER, zoo_element_defs[ZOO_E_PLAYER].color};
+
+	// only marks the board dirty if the tile was not the player already
+	zoo_board_set_tile(&state->board, state->board.stats[0].x, state->board.stats[0].y, player_tile);
+
 	state->error_value = zoo_board_close(state);
 	if (state->error_value) return;
 
@@ -74,34 +97,34 @@ void zoo_board_create(zoo_state *state) {
 		state->board.info.neighbor_boards[i] = 0;
 
 	for (ix = 0; ix <= ZOO_BOARD_WIDTH + 1; ix++) {
-		state->board.tiles[ix][0] = zoo_board_tile_edge;
-		state->board.tiles[ix][ZOO_BOARD_HEIGHT + 1] = zoo_board_tile_edge;
+		ZOO_TILE(&state->board, ix, 0) = zoo_board_tile_edge;
+		ZOO_TILE(&state->board, ix, ZOO_BOARD_HEIGHT + 1) = zoo_board_tile_edge;
 	}
 
 	for (iy = 0; iy <= ZOO_BOARD_HEIGHT + 1; iy++) {
-		state->board.tiles[0][iy] = zoo_board_tile_edge;
-		state->board.tiles[ZOO_BOARD_WIDTH + 1][iy] = zoo_board_tile_edge;
+		ZOO_TILE(&state->board, 0, iy) = zoo_board_tile_edge;
+		ZOO_TILE(&state->board, ZOO_BOARD_WIDTH + 1, iy) = zoo_board_tile_edge;
 	}
 
-	for (ix = 1; ix <= ZOO_BOARD_WIDTH; ix++) {
-		for (iy = 1; iy <= ZOO_BOARD_HEIGHT; iy++) {
-			state->board.tiles[ix][iy].element = ZOO_E_EMPTY;
-			state->board.tiles[ix][iy].color = 0x00;
+	for (iy = 1; iy <= ZOO_BOARD_HEIGHT; iy++) {
+		for (ix = 1; ix <= ZOO_BOARD_WIDTH; ix++) {
+			ZOO_TILE(&state->board, ix, iy).element = ZOO_E_EMPTY;
+			ZOO_TILE(&state->board, ix, iy).color = 0x00;
 		}
 	}
 
 	for (ix = 1; ix <= ZOO_BOARD_WIDTH; ix++) {
-		state->board.tiles[ix][1] = zoo_board_tile_border;
-		state->board.tiles[ix][ZOO_BOARD_HEIGHT] = zoo_board_tile_border;
+		ZOO_TILE(&state->board, ix, 1) = zoo_board_tile_border;
+		ZOO_TILE(&state->board, ix, ZOO_BOARD_HEIGHT) = zoo_board_tile_border;
 	}
 
 	for (iy = 1; iy <= ZOO_BOARD_HEIGHT; iy++) {
-		state->board.tiles[1][iy] = zoo_board_tile_border;
-		state->board.tiles[ZOO_BOARD_WIDTH][iy] = zoo_board_tile_border;
+		ZOO_TILE(&state->board, 1, iy) = zoo_board_tile_border;
+		ZOO_TILE(&state->board, ZOO_BOARD_WIDTH, iy) = zoo_board_tile_border;
 	}
 
-	state->board.tiles[ZOO_BOARD_WIDTH / 2][ZOO_BOARD_HEIGHT / 2].element = ZOO_E_PLAYER;
-	state->board.tiles[ZOO_BOARD_WIDTH / 2][ZOO_BOARD_HEIGHT / 2].color
+	ZOO_TILE(&state->board, ZOO_BOARD_WIDTH / 2, ZOO_BOARD_HEIGHT / 2).element = ZOO_E_PLAYER;
+	ZOO_TILE(&state->board, ZOO_BOARD_WIDTH / 2, ZOO_BOARD_HEIGHT / 2).color
 		= zoo_element_defs[ZOO_E_PLAYER].color;
 	state->board.stat_count = 0;
 	state->board.stats[0].x = ZOO_BOARD_WIDTH / 2;
@@ -111,6 +134,8 @@ void zoo_board_create(zoo_state *state) {
 	state->board.stats[0].under.color = 0x00;
 	state->board.stats[0].data = NULL;
 	state->board.stats[0].data_len = 0;
+	ZOO_BOARD_MARK_DIRTY(&state->board);
+	zoo_stat_index_build(&state->board);
 }
 
 void zoo_reset_message_flags(zoo_state *state) {
@@ -120,6 +145,7 @@ void zoo_reset_message_flags(zoo_state *state) {
 void zoo_world_create(zoo_state *state) {
 	int16_t i;
 
+	zoo_board_cache_clear(state);
 	state->world.board_count = 0;
 	state->world.board_len[0] = 0;
 	zoo_reset_message_flags(state);
@@ -149,7 +175,7 @@ void zoo_world_create(zoo_state *state) {
 
 GBA_FAST_CODE
 void zoo_board_draw_tile(zoo_state *state, int16_t x, int16_t y) {
-	uint8_t ch;
+	uint8_t ch, col;
 	zoo_tile *tile;
 
 	if (state->d_video->func_write == NULL) {
@@ -158,7 +184,7 @@ void zoo_board_draw_tile(zoo_state *state, int16_t x, int16_t y) {
 
 	// FIX: bounds check
 	if (x >= 1 && y >= 1 && x <= ZOO_BOARD_WIDTH && y <= ZOO_BOARD_HEIGHT) {
-		tile = &state->board.tiles[x][y];
+		tile = &ZOO_TILE(&state->board, x, y);
 
 		// darkness handling
 		if (
@@ -166,29 +192,37 @@ void zoo_board_draw_tile(zoo_state *state, int16_t x, int16_t y) {
 			&& !zoo_element_defs[tile->element].visible_in_dark
 			&& (
 				(state->world.info.torch_ticks <= 0)
-				|| (zoo_dist_sq2(state->board.stats[0].x - x, state->board.stats[0].y - y) >= ZOO_TORCH_DSQ)
+				|| !ZOO_TORCH_LIT(x - state->board.stats[0].x, y - state->board.stats[0].y)
 			) && !state->force_darkness_off
 		) {
-			state->d_video->func_write(state->d_video, x - 1, y - 1, 0x07, '\xB0');
-			return;
-		}
-
-		if (tile->element == ZOO_E_EMPTY) {
-			state->d_video->func_write(state->d_video, x - 1, y - 1, 0x0F, ' ');
+			col = 0x07;
+			ch = '\xB0';
+		} else if (tile->element == ZOO_E_EMPTY) {
+			col = 0x0F;
+			ch = ' ';
 		} else if (zoo_element_defs[tile->element].has_draw_func) {
-			zoo_element_defs[tile->element].draw_func(state, x, y, &ch);
-			state->d_video->func_write(state->d_video, x - 1, y - 1, tile->color, ch);
+			ZOO_PROFILE_CALL(state, element_draw, tile->element, -1,
+				zoo_element_defs[tile->element].draw_func(state, x, y, &ch));
+			col = tile->color;
 		} else if (tile->element < ZOO_E_TEXT_MIN) {
-			state->d_video->func_write(state->d_video, x - 1, y - 1, tile->color, zoo_element_defs[tile->element].character);
+			col = tile->color;
+			ch = zoo_element_defs[tile->element].character;
 		} else {
 			// text drawing
 			// TODO: VideoMonochrome?
 			if (tile->element == ZOO_E_TEXT_WHITE) {
-				state->d_video->func_write(state->d_video, x - 1, y - 1, 0x0F, tile->color);
+				col = 0x0F;
 			} else {
-				state->d_video->func_write(state->d_video, x - 1, y - 1,
-					((tile->element - ZOO_E_TEXT_MIN + 1) << 4) | 0x0F, tile->color);
+				col = ((tile->element - ZOO_E_TEXT_MIN + 1) << 4) | 0x0F;
 			}
+			ch = tile->color;
+		}
+
+		if (ZOO_VIDEO_BATCHED(state->d_video)) {
+			zoo_video_write(state, x - 1, y - 1, col, ch);
+		} else {
+			ZOO_METRICS_ADD(state, video_writes, 1);
+			state->d_video->func_write(state->d_video, x - 1, y - 1, col, ch);
 		}
 	}
 }
@@ -219,6 +253,323 @@ void zoo_board_draw(zoo_state *state) {
 	}
 }
 
+// torch row mask for board row y, shifted so that bit 0 is column base_x
+static ZOO_INLINE uint32_t zoo_torch_row(int16_t tx, int16_t ty, int16_t y, int16_t base_x) {
+	if (y < ty - ZOO_TORCH_DY || y > ty + ZOO_TORCH_DY) return 0;
+	return zoo_torch_stencil[y - ty + ZOO_TORCH_DY] << (tx - ZOO_TORCH_DX - base_x);
+}
+
+GBA_FAST_CODE
+static void zoo_board_draw_row_mask(zoo_state *state, int16_t base_x, int16_t y, uint32_t mask) {
+	int16_t ix;
+
+	for (ix = base_x; mask != 0; ix++, mask >>= 1) {
+		if ((mask & 1) && ix >= 1 && ix <= ZOO_BOARD_WIDTH) {
+			zoo_board_draw_tile(state, ix, y);
+		}
+	}
+}
+
+// Redraw the cells whose lit state differs between a torch at (old_x, old_y)
+// and one at (new_x, new_y). The two must be close enough for both stencil
+// rows to fit in one 32-bit mask.
+GBA_FAST_CODE
+static void zoo_board_draw_torch_step(zoo_state *state, int16_t old_x, int16_t old_y, int16_t new_x, int16_t new_y) {
+	int16_t iy, base_x;
+
+	base_x = (old_x < new_x ? old_x : new_x) - ZOO_TORCH_DX;
+	for (iy = (old_y < new_y ? old_y : new_y) - ZOO_TORCH_DY; iy <= (old_y > new_y ? old_y : new_y) + ZOO_TORCH_DY; iy++) {
+		if (iy >= 1 && iy <= ZOO_BOARD_HEIGHT) {
+			zoo_board_draw_row_mask(state, base_x, iy,
+				zoo_torch_row(old_x, old_y, iy, base_x) ^ zoo_torch_row(new_x, new_y, iy, base_x));
+		}
+	}
+}
+
+#ifdef ZOO_USE_STAT_INDEX
+#define ZOO_STAT_INDEX_IN_BOUNDS(x, y) ((x) >= 0 && (x) <= (ZOO_BOARD_WIDTH + 1) && (y) >= 0 && (y) <= (ZOO_BOARD_HEIGHT + 1))
+#define ZOO_STAT_INDEX(board, x, y) ((board)->stat_index[(y)][(x)])
+#define ZOO_STAT_INDEX_COUNT(board, x, y) ((board)->stat_index_count[(y)][(x)])
+
+static void zoo_stat_index_add(zoo_board *board, int16_t stat_id) {
+	zoo_stat *stat = &(board->stats[stat_id]);
+	uint8_t *idx;
+
+	if (!ZOO_STAT_INDEX_IN_BOUNDS(stat->x, stat->y)) return;
+	idx = &ZOO_STAT_INDEX(board, stat->x, stat->y);
+	ZOO_STAT_INDEX_COUNT(board, stat->x, stat->y)++;
+	if (*idx == 0 || *idx > (stat_id + 1)) {
+		*idx = stat_id + 1;
+	}
+}
+
+static void zoo_stat_index_remove(zoo_board *board, int16_t stat_id) {
+	zoo_stat *stat = &(board->stats[stat_id]);
+	uint8_t *idx;
+	int16_t i;
+
+	if (!ZOO_STAT_INDEX_IN_BOUNDS(stat->x, stat->y)) return;
+	idx = &ZOO_STAT_INDEX(board, stat->x, stat->y);
+	if ((--ZOO_STAT_INDEX_COUNT(board, stat->x, stat->y)) == 0) {
+		*idx = 0;
+	} else if (*idx == (stat_id + 1)) {
+		// tile still shared - find the next lowest stat ID on it
+		for (i = stat_id + 1; i <= board->stat_count; i++) {
+			if (board->stats[i].x == stat->x && board->stats[i].y == stat->y) {
+				*idx = i + 1;
+				break;
+			}
+		}
+	}
+}
+
+static void zoo_stat_index_move(zoo_board *board, int16_t stat_id, int16_t new_x, int16_t new_y) {
+	zoo_stat_index_remove(board, stat_id);
+	board->stats[stat_id].x = new_x;
+	board->stats[stat_id].y = new_y;
+	zoo_stat_index_add(board, stat_id);
+}
+#else
+#define zoo_stat_index_add(board, stat_id)
+#define zoo_stat_index_remove(board, stat_id)
+
+static void zoo_stat_index_move(zoo_board *board, int16_t stat_id, int16_t new_x, int16_t new_y) {
+	board->stats[stat_id].x = new_x;
+	board->stats[stat_id].y = new_y;
+}
+#endif
+
+#define ZOO_STAT_SCHED_BUCKET(cycle, phase) (((cycle) * ((cycle) - 1) / 2) + (phase))
+
+static uint32_t *zoo_stat_sched_bits(zoo_board *board, int16_t stat_id) {
+	int16_t cycle = board->stats[stat_id].cycle;
+
+	if (cycle == 0) {
+		return NULL;
+	} else if (cycle >= 1 && cycle <= ZOO_STAT_SCHED_CYCLES) {
+		return board->stat_sched[ZOO_STAT_SCHED_BUCKET(cycle, stat_id % cycle)];
+	} else {
+		return board->stat_sched_other;
+	}
+}
+
+static void zoo_stat_sched_add(zoo_board *board, int16_t stat_id) {
+	uint32_t *bits = zoo_stat_sched_bits(board, stat_id);
+
+	if (bits != NULL) {
+		bits[stat_id >> 5] |= (1U << (stat_id & 31));
+	}
+	board->stat_sched_tick = -1;
+}
+
+static void zoo_stat_sched_remove(zoo_board *board, int16_t stat_id) {
+	uint32_t *bits = zoo_stat_sched_bits(board, stat_id);
+
+	if (bits != NULL) {
+		bits[stat_id >> 5] &= ~(1U << (stat_id & 31));
+	}
+	board->stat_sched_tick = -1;
+}
+
+static void zoo_stat_sched_build(zoo_board *board) {
+	int16_t i;
+
+	memset(board->stat_sched, 0, sizeof(board->stat_sched));
+	memset(board->stat_sched_other, 0, sizeof(board->stat_sched_other));
+	for (i = 0; i <= board->stat_count; i++) {
+		zoo_stat_sched_add(board, i);
+	}
+}
+
+static void zoo_stat_sched_update_due(zoo_board *board, int16_t tick) {
+	int16_t c, i, w;
+	uint32_t *bucket;
+	uint32_t other;
+
+	memset(board->stat_sched_due, 0, sizeof(board->stat_sched_due));
+	for (c = 1; c <= ZOO_STAT_SCHED_CYCLES; c++) {
+		bucket = board->stat_sched[ZOO_STAT_SCHED_BUCKET(c, tick % c)];
+		for (w = 0; w < ZOO_STAT_SCHED_WORDS; w++) {
+			board->stat_sched_due[w] |= bucket[w];
+		}
+	}
+
+	for (w = 0; w < ZOO_STAT_SCHED_WORDS; w++) {
+		other = board->stat_sched_other[w];
+		while (other != 0) {
+			i = (w << 5) + zoo_ctz32(other);
+			other &= other - 1;
+			c = board->stats[i].cycle;
+			if ((tick % c) == (i % c)) {
+				board->stat_sched_due[w] |= (1U << (i & 31));
+			}
+		}
+	}
+
+	board->stat_sched_tick = tick;
+}
+
+static ZOO_INLINE bool zoo_stat_sched_is_due(zoo_board *board, int16_t tick, int16_t stat_id) {
+	if (board->stat_sched_tick != tick) {
+		zoo_stat_sched_update_due(board, tick);
+	}
+	return (board->stat_sched_due[stat_id >> 5] >> (stat_id & 31)) & 1;
+}
+
+// Returns the first stat ID >= from which is due on this tick,
+// or stat_count + 1 if there is none (from, if already past the end).
+GBA_FAST_CODE
+static int16_t zoo_stat_sched_next(zoo_board *board, int16_t tick, int16_t from) {
+	int16_t w, i;
+	uint32_t mask;
+
+	if (from < 0) from = 0;
+	if (from > board->stat_count) return from;
+
+	if (board->stat_sched_tick != tick) {
+		zoo_stat_sched_update_due(board, tick);
+	}
+
+	w = from >> 5;
+	mask = board->stat_sched_due[w] & (0xFFFFFFFFU << (from & 31));
+	while (true) {
+		if (mask != 0) {
+			i = (w << 5) + zoo_ctz32(mask);
+			if (i <= board->stat_count) return i;
+			break;
+		}
+		if ((++w) >= ZOO_STAT_SCHED_WORDS) break;
+		mask = board->stat_sched_due[w];
+	}
+
+	return board->stat_count + 1;
+}
+
+#ifdef ZOO_USE_ELEMENT_INDEX
+#define ZOO_ELEMENT_INDEX_IN_BOUNDS(x, y) ((x) >= 1 && (x) <= ZOO_BOARD_WIDTH && (y) >= 1 && (y) <= ZOO_BOARD_HEIGHT)
+
+void zoo_element_index_update(zoo_board *board, int16_t x, int16_t y, uint8_t old_element, uint8_t new_element) {
+	uint32_t *row;
+	int16_t w;
+
+	if (old_element == new_element || !ZOO_ELEMENT_INDEX_IN_BOUNDS(x, y)) return;
+	x--;
+	y--;
+
+	if (old_element <= ZOO_MAX_ELEMENT) {
+		row = board->element_index[old_element][y];
+		row[x >> 5] &= ~(1UL << (x & 31));
+		for (w = 0; w < ZOO_BOARD_ROW_WORDS; w++) {
+			if (row[w] != 0) break;
+		}
+		if (w == ZOO_BOARD_ROW_WORDS) {
+			board->element_index_rows[old_element] &= ~(1UL << y);
+		}
+	}
+
+	if (new_element <= ZOO_MAX_ELEMENT) {
+		board->element_index[new_element][y][x >> 5] |= (1UL << (x & 31));
+		board->element_index_rows[new_element] |= (1UL << y);
+	}
+}
+
+static void zoo_element_index_build(zoo_board *board) {
+	int16_t ix, iy;
+	uint8_t element;
+
+	memset(board->element_index, 0, sizeof(board->element_index));
+	memset(board->element_index_rows, 0, sizeof(board->element_index_rows));
+	for (iy = 1; iy <= ZOO_BOARD_HEIGHT; iy++) {
+		for (ix = 1; ix <= ZOO_BOARD_WIDTH; ix++) {
+			element = ZOO_TILE(board, ix, iy).element;
+			if (element <= ZOO_MAX_ELEMENT) {
+				board->element_index[element][iy - 1][(ix - 1) >> 5] |= (1UL << ((ix - 1) & 31));
+				board->element_index_rows[element] |= (1UL << (iy - 1));
+			}
+		}
+	}
+}
+
+// Find the next tile of the given element after (*x, *y) in row-major order.
+bool zoo_element_index_next(zoo_board *board, uint8_t element, int16_t *x, int16_t *y) {
+	int16_t ix = *x;
+	int16_t iy = *y - 1;
+	uint32_t rows, word;
+	int16_t w;
+
+	if (element > ZOO_MAX_ELEMENT) return false;
+
+	// ix is the 0-based column after *x
+	if (ix >= ZOO_BOARD_WIDTH) {
+		ix = 0;
+		iy++;
+	}
+	if (iy < 0) {
+		ix = 0;
+		iy = 0;
+	}
+	if (iy >= ZOO_BOARD_HEIGHT) return false;
+
+	rows = board->element_index_rows[element] >> iy;
+	while (rows != 0) {
+		if (rows & 1) {
+			for (w = ix >> 5; w < ZOO_BOARD_ROW_WORDS; w++) {
+				word = board->element_index[element][iy][w];
+				if (w == (ix >> 5)) {
+					word &= ~((1UL << (ix & 31)) - 1);
+				}
+				if (word != 0) {
+					*x = (w << 5) + zoo_ctz32(word) + 1;
+					*y = iy + 1;
+					return true;
+				}
+			}
+		}
+		rows >>= 1;
+		iy++;
+		ix = 0;
+	}
+
+	return false;
+}
+#endif
+
+void zoo_stat_index_build(zoo_board *board) {
+#ifdef ZOO_USE_STAT_INDEX
+	int16_t i;
+
+	memset(board->stat_index, 0, sizeof(board->stat_index));
+	memset(board->stat_index_count, 0, sizeof(board->stat_index_count));
+	for (i = 0; i <= board->stat_count; i++) {
+		zoo_stat_index_add(board, i);
+	}
+#endif
+	zoo_stat_sched_build(board);
+	board->name_hash_valid = false;
+#ifdef ZOO_USE_ELEMENT_INDEX
+	zoo_element_index_build(board);
+#endif
+}
+
+void zoo_stat_set_cycle(zoo_state *state, int16_t stat_id, int16_t cycle) {
+	zoo_stat_sched_remove(&state->board, stat_id);
+	state->board.stats[stat_id].cycle = cycle;
+	zoo_stat_sched_add(&state->board, stat_id);
+}
+
+// Returns true if the template is a stat on the board (so its object code
+// is reference counted), and no other stat is bound to its code.
+static bool zoo_stat_data_shareable(zoo_board *board, const zoo_stat *stat_template, const zoo_stat *stat) {
+	bool on_board = false;
+	int16_t i;
+
+	for (i = 1; i <= board->stat_count; i++) {
+		if (&board->stats[i] == stat_template) on_board = true;
+		else if (&board->stats[i] != stat && zoo_stat_data_bound(&board->stats[i], stat_template)) return false;
+	}
+	return on_board;
+}
+
 void zoo_stat_add(zoo_state *state, int16_t tx, int16_t ty, uint8_t element, int16_t color, int16_t tcycle, const zoo_stat *stat_template) {
 	zoo_stat *stat;
 
@@ -227,23 +578,51 @@ void zoo_stat_add(zoo_state *state, int16_t tx, int16_t ty, uint8_t element, int
 		stat = &(state->board.stats[state->board.stat_count]);
 
 		memcpy(stat, stat_template, sizeof(zoo_stat));
+		stat->oop_limit_hits = 0;
 		stat->x = tx;
 		stat->y = ty;
 		stat->cycle = tcycle;
-		stat->under = state->board.tiles[tx][ty];
+		stat->under = ZOO_TILE(&state->board, tx, ty);
 		stat->data_pos = 0;
+		zoo_stat_index_add(&state->board, state->board.stat_count);
+		zoo_stat_sched_add(&state->board, state->board.stat_count);
 
 		if (stat_template->data != NULL) {
-			stat->data = malloc(stat->data_len);
-			memcpy(stat->data, stat_template->data, stat->data_len);
+			// share the template's code until either of them writes to it;
+			// code in ROM, bound to other stats or from elsewhere is copied
+			if (!platform_is_rom_ptr(stat_template->data) && zoo_stat_data_shareable(&state->board, stat_template, stat)) {
+				stat->data = zoo_stat_data_ref(stat_template->data);
+			} else {
+				stat->data = zoo_stat_data_alloc(stat->data_len);
+				ZOO_METRICS_ADD(state, mallocs, 1);
+				memcpy(stat->data, stat_template->data, stat->data_len);
+			}
+#ifdef ZOO_USE_LABEL_CACHE
+			// the clone's code matches the template's, zaps included
+			if (stat->label_cache_size > 1) {
+				stat->label_cache = malloc(zoo_oop_label_cache_bytes(stat->label_cache_size - 1));
+				ZOO_METRICS_ADD(state, mallocs, 1);
+				if (stat->label_cache != NULL)
+					memcpy(stat->label_cache, stat_template->label_cache, zoo_oop_label_cache_bytes(stat->label_cache_size - 1));
+				else
+					stat->label_cache_size = 0;
+			} else {
+				stat->label_cache = NULL;
+			}
+#endif
+		}
+
+		if (state->board.name_hash_valid) {
+			state->board.name_hash[state->board.stat_count] = zoo_oop_name_hash(state, state->board.stat_count);
+			state->board.name_chain_valid = false;
 		}
 
-		if (zoo_element_defs[state->board.tiles[tx][ty].element].placeable_on_top) {
-			state->board.tiles[tx][ty].color = (state->board.tiles[tx][ty].color & 0x70) | (color & 0x0F);
+		if (zoo_element_defs[ZOO_TILE(&state->board, tx, ty).element].placeable_on_top) {
+			zoo_board_set_color(&state->board, tx, ty, (ZOO_TILE(&state->board, tx, ty).color & 0x70) | (color & 0x0F));
 		} else {
-			state->board.tiles[tx][ty].color = color;
+			zoo_board_set_color(&state->board, tx, ty, color);
 		}
-		state->board.tiles[tx][ty].element = element;
+		zoo_board_set_element(&state->board, tx, ty, element);
 
 		if (ty > 0) {
 			zoo_board_draw_tile(state, tx, ty);
@@ -262,7 +641,7 @@ void zoo_stat_remove(zoo_state *state, int16_t stat_id) {
 	if (stat->data_len != 0) {
 		for (i = 1; i <= state->board.stat_count; i++) {
 			if (i == stat_id) continue;
-			if (state->board.stats[i].data == stat->data) goto StatDataInUse;
+			if (zoo_stat_data_bound(&state->board.stats[i], stat)) goto StatDataInUse;
 		}
 	}
 	zoo_stat_free(stat);
@@ -272,7 +651,7 @@ StatDataInUse:
 		state->current_stat_tick--;
 	}
 
-	state->board.tiles[stat->x][stat->y] = stat->under;
+	zoo_board_set_tile(&state->board, stat->x, stat->y, stat->under);
 	if (stat->y > 0) {
 		zoo_board_draw_tile(state, stat->x, stat->y);
 	}
@@ -295,10 +674,21 @@ StatDataInUse:
 		}
 	}
 
+	zoo_stat_index_remove(&state->board, stat_id);
 	for (i = stat_id + 1; i <= state->board.stat_count; i++) {
-		state->board.stats[i - 1] = state->board.stats[i];
+		stat = &(state->board.stats[i]);
+#ifdef ZOO_USE_STAT_INDEX
+		if (ZOO_STAT_INDEX_IN_BOUNDS(stat->x, stat->y) && ZOO_STAT_INDEX(&state->board, stat->x, stat->y) == (i + 1)) {
+			ZOO_STAT_INDEX(&state->board, stat->x, stat->y) = i;
+		}
+#endif
+		state->board.stats[i - 1] = *stat;
+		state->board.name_hash[i - 1] = state->board.name_hash[i];
 	}
 	state->board.stat_count--;
+	state->board.name_chain_valid = false;
+	// stat IDs have shifted, so their phases have changed
+	zoo_stat_sched_build(&state->board);
 }
 
 GBA_FAST_CODE
@@ -306,6 +696,12 @@ int16_t zoo_stat_get_id(zoo_state *state, int16_t x, int16_t y) {
 	int16_t i;
 	zoo_stat *stat = state->board.stats;
 
+#ifdef ZOO_USE_STAT_INDEX
+	if (ZOO_STAT_INDEX_IN_BOUNDS(x, y)) {
+		return ((int16_t) ZOO_STAT_INDEX(&state->board, x, y)) - 1;
+	}
+#endif
+
 	for (i = 0; i <= state->board.stat_count; i++, stat++) {
 		if (x == stat->x && y == stat->y)
 			return i;
@@ -319,6 +715,16 @@ zoo_stat *zoo_stat_get(zoo_state *state, int16_t x, int16_t y, int16_t *stat_id)
 	int16_t i;
 	zoo_stat *stat = state->board.stats;
 
+#ifdef ZOO_USE_STAT_INDEX
+	if (ZOO_STAT_INDEX_IN_BOUNDS(x, y)) {
+		i = ((int16_t) ZOO_STAT_INDEX(&state->board, x, y)) - 1;
+		if (stat_id != NULL) {
+			*stat_id = i;
+		}
+		return i >= 0 ? &(state->board.stats[i]) : NULL;
+	}
+#endif
+
 	for (i = 0; i <= state->board.stat_count; i++, stat++) {
 		if (x == stat->x && y == stat->y) {
 			if (stat_id != NULL) {
@@ -338,7 +744,6 @@ void zoo_stat_move(zoo_state *state, int16_t stat_id, int16_t new_x, int16_t new
 	zoo_stat *stat;
 	zoo_tile under;
 	int16_t old_x, old_y;
-	int16_t ix, iy;
 
 	// FIX: bounds check
 	if (stat_id < 0 || stat_id > state->board.stat_count) return;
@@ -346,39 +751,30 @@ void zoo_stat_move(zoo_state *state, int16_t stat_id, int16_t new_x, int16_t new
 	stat = &(state->board.stats[stat_id]);
 
 	under = stat->under;
-	stat->under = state->board.tiles[new_x][new_y];
+	stat->under = ZOO_TILE(&state->board, new_x, new_y);
 
-	if (state->board.tiles[stat->x][stat->y].element == ZOO_E_PLAYER) {
-		state->board.tiles[new_x][new_y].color = state->board.tiles[stat->x][stat->y].color;
-	} else if (state->board.tiles[new_x][new_y].element == ZOO_E_EMPTY) {
-		state->board.tiles[new_x][new_y].color = state->board.tiles[stat->x][stat->y].color & 0x0F;
+	if (ZOO_TILE(&state->board, stat->x, stat->y).element == ZOO_E_PLAYER) {
+		zoo_board_set_color(&state->board, new_x, new_y, ZOO_TILE(&state->board, stat->x, stat->y).color);
+	} else if (ZOO_TILE(&state->board, new_x, new_y).element == ZOO_E_EMPTY) {
+		zoo_board_set_color(&state->board, new_x, new_y, ZOO_TILE(&state->board, stat->x, stat->y).color & 0x0F);
 	} else {
-		state->board.tiles[new_x][new_y].color = (state->board.tiles[stat->x][stat->y].color & 0x0F)
-			+ (state->board.tiles[new_x][new_y].color & 0x70);
+		zoo_board_set_color(&state->board, new_x, new_y, (ZOO_TILE(&state->board, stat->x, stat->y).color & 0x0F)
+			+ (ZOO_TILE(&state->board, new_x, new_y).color & 0x70));
 	}
 
-	state->board.tiles[new_x][new_y].element = state->board.tiles[stat->x][stat->y].element;
-	state->board.tiles[stat->x][stat->y] = under;
+	zoo_board_set_element(&state->board, new_x, new_y, ZOO_TILE(&state->board, stat->x, stat->y).element);
+	zoo_board_set_tile(&state->board, stat->x, stat->y, under);
 
 	old_x = stat->x;
 	old_y = stat->y;
-	stat->x = new_x;
-	stat->y = new_y;
+	zoo_stat_index_move(&state->board, stat_id, new_x, new_y);
 
 	zoo_board_draw_tile(state, stat->x, stat->y);
 	zoo_board_draw_tile(state, old_x, old_y);
 
 	if (stat_id == 0 && state->board.info.is_dark && state->world.info.torch_ticks > 0) {
 		if (zoo_dist_sq(old_x - stat->x, old_y - stat->y) == 1) {
-			for (ix = stat->x - ZOO_TORCH_DX - 3; ix <= stat->x + ZOO_TORCH_DX + 3; ix++)
-			if (ix >= 1 && ix <= ZOO_BOARD_WIDTH)
-			for (iy = stat->y - ZOO_TORCH_DY - 3; iy <= stat->y + ZOO_TORCH_DY + 3; iy++)
-			if (iy >= 1 && iy <= ZOO_BOARD_HEIGHT) {
-				if ((zoo_dist_sq2(ix - old_x, iy - old_y) < ZOO_TORCH_DSQ)
-					^ (zoo_dist_sq2(ix - new_x, iy - new_y) < ZOO_TORCH_DSQ)) {
-					zoo_board_draw_tile(state, ix, iy);
-				}
-			}
+			zoo_board_draw_torch_step(state, old_x, old_y, stat->x, stat->y);
 		} else {
 			zoo_draw_player_surroundings(state, old_x, old_y, 0);
 			zoo_draw_player_surroundings(state, stat->x, stat->y, 0);
@@ -420,7 +816,7 @@ void zoo_board_damage_stat(zoo_state *state, int16_t stat_id) {
 			state->func_draw_sidebar(state, ZOO_SIDEBAR_UPDATE_HEALTH);
 			zoo_display_message(state, 100, "Ouch!");
 
-			state->board.tiles[stat->x][stat->y].color = 0x70 | (zoo_element_defs[ZOO_E_PLAYER].color & 0x0F);
+			zoo_board_set_color(&state->board, stat->x, stat->y, 0x70 | (zoo_element_defs[ZOO_E_PLAYER].color & 0x0F));
 
 			if (state->world.info.health > 0) {
 				state->world.info.board_time_sec = 0;
@@ -428,12 +824,13 @@ void zoo_board_damage_stat(zoo_state *state, int16_t stat_id) {
 					zoo_sound_queue_const(&(state->sound), 4, "\x20\x01\x23\x01\x27\x01\x30\x01\x10\x01");
 
 					// move player to start
-					state->board.tiles[stat->x][stat->y].element = ZOO_E_EMPTY;
+					zoo_board_set_element(&state->board, stat->x, stat->y, ZOO_E_EMPTY);
 					zoo_board_draw_tile(state, stat->x, stat->y);
 					old_x = stat->x;
 					old_y = stat->y;
-					stat->x = state->board.info.start_player_x;
-					stat->y = state->board.info.start_player_y;
+					zoo_stat_index_move(&state->board, stat_id,
+						state->board.info.start_player_x,
+						state->board.info.start_player_y);
 					zoo_draw_player_surroundings(state, old_x, old_y, 0);
 					zoo_draw_player_surroundings(state, stat->x, stat->y, 0);
 
@@ -449,7 +846,7 @@ void zoo_board_damage_stat(zoo_state *state, int16_t stat_id) {
 			}
 		}
 	} else {
-		switch (state->board.tiles[stat->x][stat->y].element) {
+		switch (ZOO_TILE(&state->board, stat->x, stat->y).element) {
 			case ZOO_E_BULLET: zoo_sound_queue_const(&(state->sound), 3, "\x20\x01"); break;
 			case ZOO_E_OBJECT: break;
 			default: zoo_sound_queue_const(&(state->sound), 3, "\x40\x01\x10\x01\x50\x01\x30\x01"); break;
@@ -464,14 +861,14 @@ void zoo_board_damage_tile(zoo_state *state, int16_t x, int16_t y) {
 	if (stat_id != -1) {
 		zoo_board_damage_stat(state, stat_id);
 	} else {
-		state->board.tiles[x][y].element = ZOO_E_EMPTY;
+		zoo_board_set_element(&state->board, x, y, ZOO_E_EMPTY);
 		zoo_board_draw_tile(state, x, y);
 	}
 }
 
 void zoo_board_attack_tile(zoo_state *state, int16_t attacker_stat_id, int16_t x, int16_t y) {
 	if ((attacker_stat_id == 0) && (state->world.info.energizer_ticks > 0)) {
-		state->world.info.score += zoo_element_defs[state->board.tiles[x][y].element].score_value;
+		state->world.info.score += zoo_element_defs[ZOO_TILE(&state->board, x, y).element].score_value;
 		state->func_draw_sidebar(state, ZOO_SIDEBAR_UPDATE_SCORE);
 	} else {
 		zoo_board_damage_stat(state, attacker_stat_id);
@@ -481,10 +878,10 @@ void zoo_board_attack_tile(zoo_state *state, int16_t attacker_stat_id, int16_t x
 		state->current_stat_tick--;
 	}
 
-	if ((state->board.tiles[x][y].element == ZOO_E_PLAYER) && (state->world.info.energizer_ticks > 0)) {
-		state->world.info.score += zoo_element_defs[state->board.tiles
-			[state->board.stats[attacker_stat_id].x]
-			[state->board.stats[attacker_stat_id].y]
+	if ((ZOO_TILE(&state->board, x, y).element == ZOO_E_PLAYER) && (state->world.info.energizer_ticks > 0)) {
+		state->world.info.score += zoo_element_defs[ZOO_TILE(&state->board,
+			state->board.stats[attacker_stat_id].x,
+			state->board.stats[attacker_stat_id].y)
 		.element].score_value;
 		state->func_draw_sidebar(state, ZOO_SIDEBAR_UPDATE_SCORE);
 	} else {
@@ -494,8 +891,8 @@ void zoo_board_attack_tile(zoo_state *state, int16_t attacker_stat_id, int16_t x
 }
 
 bool zoo_board_shoot(zoo_state *state, uint8_t element, int16_t x, int16_t y, int16_t dx, int16_t dy, int16_t param1) {
-	if ((zoo_element_defs[state->board.tiles[x+dx][y+dy].element].walkable)
-		|| (state->board.tiles[x+dx][y+dy].element == ZOO_E_WATER))
+	if ((zoo_element_defs[ZOO_TILE(&state->board, x+dx, y+dy).element].walkable)
+		|| (ZOO_TILE(&state->board, x+dx, y+dy).element == ZOO_E_WATER))
 	{
 		zoo_stat_add(state, x + dx, y + dy, element, zoo_element_defs[element].color, 1, &zoo_stat_template_default);
 		state->board.stats[state->board.stat_count].p1 = param1;
@@ -503,10 +900,10 @@ bool zoo_board_shoot(zoo_state *state, uint8_t element, int16_t x, int16_t y, in
 		state->board.stats[state->board.stat_count].step_y = dy;
 		state->board.stats[state->board.stat_count].p2 = 100;
 		return true;
-	} else if (state->board.tiles[x+dx][y+dy].element == ZOO_E_BREAKABLE
+	} else if (ZOO_TILE(&state->board, x+dx, y+dy).element == ZOO_E_BREAKABLE
 		|| (
-			zoo_element_defs[state->board.tiles[x+dx][y+dy].element].destructible
-			&& ((state->board.tiles[x+dx][y+dy].element == ZOO_E_PLAYER) == (param1 != 0))
+			zoo_element_defs[ZOO_TILE(&state->board, x+dx, y+dy).element].destructible
+			&& ((ZOO_TILE(&state->board, x+dx, y+dy).element == ZOO_E_PLAYER) == (param1 != 0))
 			&& (state->world.info.energizer_ticks <= 0)
 		)
 	) {
@@ -563,28 +960,41 @@ void zoo_board_passage_teleport(zoo_state *state, int16_t x, int16_t y) {
 	int16_t ix, iy, new_x, new_y;
 
 	stat = zoo_stat_get(state, x, y, NULL);
-	color = state->board.tiles[x][y].color;
+	color = ZOO_TILE(&state->board, x, y).color;
 	old_board = state->world.info.current_board;
 	zoo_board_change(state, stat != NULL ? stat->p3 : 0);
 
 	new_x = 0;
-	for (ix = 1; ix <= ZOO_BOARD_WIDTH; ix++) {
-		for (iy = 1; iy <= ZOO_BOARD_HEIGHT; iy++) {
+	new_y = 0;
+#ifdef ZOO_USE_ELEMENT_INDEX
+	// last match in column-major order: rightmost column, then lowest row
+	ix = 0;
+	iy = 1;
+	while (zoo_element_index_next(&state->board, ZOO_E_PASSAGE, &ix, &iy)) {
+		if (ZOO_TILE(&state->board, ix, iy).color == color && (ix > new_x || (ix == new_x && iy > new_y))) {
+			new_x = ix;
+			new_y = iy;
+		}
+	}
+#else
+	// last match in column-major order, as above
+	for (iy = 1; iy <= ZOO_BOARD_HEIGHT; iy++) {
+		for (ix = 1; ix <= ZOO_BOARD_WIDTH; ix++) {
 			if (
-				state->board.tiles[ix][iy].element == ZOO_E_PASSAGE
-				&& state->board.tiles[ix][iy].color == color
+				ZOO_TILE(&state->board, ix, iy).element == ZOO_E_PASSAGE
+				&& ZOO_TILE(&state->board, ix, iy).color == color
+				&& ix >= new_x
 			) {
 				new_x = ix;
 				new_y = iy;
 			}
 		}
 	}
+#endif
 
-	state->board.tiles[state->board.stats[0].x][state->board.stats[0].y].element = ZOO_E_EMPTY;
-	state->board.tiles[state->board.stats[0].x][state->board.stats[0].y].color = 0x00;
+	zoo_board_set_tile(&state->board, state->board.stats[0].x, state->board.stats[0].y, zoo_board_tile_empty);
 	if (new_x != 0) {
-		state->board.stats[0].x = new_x;
-		state->board.stats[0].y = new_y;
+		zoo_stat_index_move(&state->board, 0, new_x, new_y);
 	}
 
 	state->game_paused = true;
@@ -647,7 +1057,7 @@ void zoo_game_debug_command(zoo_state *state, const char *in_cmd) {
 			ix = state->board.stats[0].x + zoo_neighbor_delta_x[i];
 			iy = state->board.stats[0].y + zoo_neighbor_delta_y[i];
 			zoo_board_damage_tile(state, ix, iy);
-			state->board.tiles[ix][iy].element = ZOO_E_EMPTY;
+			zoo_board_set_element(&state->board, ix, iy, ZOO_E_EMPTY);
 			zoo_board_draw_tile(state, ix, iy);
 		}
 	}
@@ -675,10 +1085,10 @@ void zoo_game_start(zoo_state *state, zoo_game_state game_state) {
 	state->tick_duration = state->tick_speed * 2;
 	state->time_elapsed = 0;
 
-	state->board.tiles[state->board.stats[0].x][state->board.stats[0].y].element
-		= (state->game_state == GS_TITLE) ? ZOO_E_MONITOR : ZOO_E_PLAYER;
-	state->board.tiles[state->board.stats[0].x][state->board.stats[0].y].color
-		= zoo_element_defs[(state->game_state == GS_TITLE) ? ZOO_E_MONITOR : ZOO_E_PLAYER].color;
+	zoo_board_set_element(&state->board, state->board.stats[0].x, state->board.stats[0].y,
+		(state->game_state == GS_TITLE) ? ZOO_E_MONITOR : ZOO_E_PLAYER);
+	zoo_board_set_color(&state->board, state->board.stats[0].x, state->board.stats[0].y,
+		zoo_element_defs[(state->game_state == GS_TITLE) ? ZOO_E_MONITOR : ZOO_E_PLAYER].color);
 
 	zoo_board_enter(state);
 
@@ -729,11 +1139,16 @@ static ZOO_INLINE zoo_tick_retval zoo_call_stack_tick(zoo_state *state) {
 				state->call_stack.curr_call = &call;
 				switch (call.type) {
 					case TICK_FUNC:
-						call.args.tick.func(state, call.args.tick.stat_id);
+						ZOO_PROFILE_CALL(state, element_tick,
+							ZOO_TILE(&state->board, state->board.stats[call.args.tick.stat_id].x, state->board.stats[call.args.tick.stat_id].y).element,
+							call.args.tick.stat_id,
+							call.args.tick.func(state, call.args.tick.stat_id));
 						break;
 					case TOUCH_FUNC:
-						call.args.touch.func(state, call.args.touch.x, call.args.touch.y,
-							call.args.touch.source_stat_id, call.args.touch.dx, call.args.touch.dy);
+						ZOO_PROFILE_CALL(state, element_touch,
+							ZOO_TILE(&state->board, call.args.touch.x, call.args.touch.y).element, -1,
+							call.args.touch.func(state, call.args.touch.x, call.args.touch.y,
+								call.args.touch.source_stat_id, call.args.touch.dx, call.args.touch.dy));
 						break;
 					default:
 						break;
@@ -747,9 +1162,31 @@ static ZOO_INLINE zoo_tick_retval zoo_call_stack_tick(zoo_state *state) {
 	return EXIT; // never returned officially, so we repurpose it to mean "continue"
 }
 
-static zoo_tick_retval zoo_game_tick(zoo_state *state) {
+#ifdef ZOO_METRICS
+static void zoo_metrics_cycle_end(zoo_state *state) {
+	if (state->func_metrics != NULL) {
+		// every call stack push is a malloc
+		state->metrics.call_pushes += state->call_stack.metrics_pushes;
+		state->metrics.mallocs += state->call_stack.metrics_pushes + state->board.metrics_mallocs;
+		state->metrics.sound_notes_queued += state->sound.metrics_notes;
+		state->func_metrics(state, &state->metrics);
+	}
+
+	state->call_stack.metrics_pushes = 0;
+	state->sound.metrics_notes = 0;
+	state->board.metrics_mallocs = 0;
+	memset(&state->metrics, 0, sizeof(zoo_metrics));
+}
+#endif
+
+// budget: maximum number of stats to step through before returning
+// RETURN_IMMEDIATE; 0 = until the end of the cycle
+static zoo_tick_retval zoo_game_tick(zoo_state *state, uint16_t budget) {
 	int i;
+	uint8_t element;
 	uint8_t call_state;
+	bool oop_yield = false;
+	zoo_game_state game_state = state->game_state;
 
 	call_state = state->game_tick_state;
 	state->game_tick_state = 0;
@@ -768,17 +1205,17 @@ static zoo_tick_retval zoo_game_tick(zoo_state *state) {
 			}
 
 			if (state->game_paused_blink) {
-				state->d_video->func_write(
-					state->d_video,
+				zoo_video_write(
+					state,
 					state->board.stats[0].x - 1,
 					state->board.stats[0].y - 1,
 					zoo_element_defs[ZOO_E_PLAYER].color,
 					zoo_element_defs[ZOO_E_PLAYER].character
 				);
 			} else {
-				if (state->board.tiles[state->board.stats[0].x][state->board.stats[0].y].element == ZOO_E_PLAYER) {
-					state->d_video->func_write(
-						state->d_video,
+				if (ZOO_TILE(&state->board, state->board.stats[0].x, state->board.stats[0].y).element == ZOO_E_PLAYER) {
+					zoo_video_write(
+						state,
 						state->board.stats[0].x - 1,
 						state->board.stats[0].y - 1,
 						0x0F, ' '
@@ -800,15 +1237,16 @@ static zoo_tick_retval zoo_game_tick(zoo_state *state) {
 			// push self
 			state->game_tick_state = 1;
 			// touch
-			zoo_element_defs[state->board.tiles
-				[state->board.stats[0].x + state->input.delta_x]
-				[state->board.stats[0].y + state->input.delta_y]
-			.element].touch_func(state,
+			element = ZOO_TILE(&state->board,
 				state->board.stats[0].x + state->input.delta_x,
-				state->board.stats[0].y + state->input.delta_y,
-				0, &state->input.delta_x,
-				&state->input.delta_y
-			);
+				state->board.stats[0].y + state->input.delta_y).element;
+			ZOO_PROFILE_CALL(state, element_touch, element, -1,
+				zoo_element_defs[element].touch_func(state,
+					state->board.stats[0].x + state->input.delta_x,
+					state->board.stats[0].y + state->input.delta_y,
+					0, &state->input.delta_x,
+					&state->input.delta_y
+				));
 			// return
 			return RETURN_IMMEDIATE;
 		}
@@ -816,23 +1254,24 @@ static zoo_tick_retval zoo_game_tick(zoo_state *state) {
 GameTickState1:
 		if (
 			(state->input.delta_x != 0 || state->input.delta_y != 0)
-			&& zoo_element_defs[state->board.tiles
-				[state->board.stats[0].x + state->input.delta_x]
-				[state->board.stats[0].y + state->input.delta_y]
+			&& zoo_element_defs[ZOO_TILE(&state->board,
+				state->board.stats[0].x + state->input.delta_x,
+				state->board.stats[0].y + state->input.delta_y)
 			.element].walkable
 		) {
-			if (state->board.tiles[state->board.stats[0].x][state->board.stats[0].y].element == ZOO_E_PLAYER) {
+			if (ZOO_TILE(&state->board, state->board.stats[0].x, state->board.stats[0].y).element == ZOO_E_PLAYER) {
 				zoo_stat_move(state, 0,
 					state->board.stats[0].x + state->input.delta_x,
 					state->board.stats[0].y + state->input.delta_y
 				);
 			} else {
 				zoo_board_draw_tile(state, state->board.stats[0].x, state->board.stats[0].y);
-				state->board.stats[0].x += state->input.delta_x;
-				state->board.stats[0].y += state->input.delta_y;
-				state->board.tiles[state->board.stats[0].x][state->board.stats[0].y].element = ZOO_E_PLAYER;
-				state->board.tiles[state->board.stats[0].x][state->board.stats[0].y].color
-					= zoo_element_defs[ZOO_E_PLAYER].color;
+				zoo_stat_index_move(&state->board, 0,
+					state->board.stats[0].x + state->input.delta_x,
+					state->board.stats[0].y + state->input.delta_y);
+				zoo_board_set_element(&state->board, state->board.stats[0].x, state->board.stats[0].y, ZOO_E_PLAYER);
+				zoo_board_set_color(&state->board, state->board.stats[0].x, state->board.stats[0].y,
+					zoo_element_defs[ZOO_E_PLAYER].color);
 				zoo_board_draw_tile(state, state->board.stats[0].x, state->board.stats[0].y);
 				zoo_draw_player_surroundings(state, state->board.stats[0].x, state->board.stats[0].y, 0);
 				zoo_draw_player_surroundings(state,
@@ -848,22 +1287,29 @@ GameTickState1:
 			state->current_stat_tick = state->board.stat_count + 1;
 			state->world.info.is_save = true;
 
+			state->cycle_count++;
 			return RETURN_NEXT_CYCLE;
 		} else {
+			state->cycle_count++;
 			return RETURN_NEXT_CYCLE;
 		}
 	} else {
 		// not paused
-		if (state->current_stat_tick <= state->board.stat_count) {
+		while (true) {
+			if (!state->game_play_exit_requested) {
+				// skip ahead to the next stat due on this tick; with an exit
+				// requested, every stat costs one call, so step one by one
+				state->current_stat_tick = zoo_stat_sched_next(&state->board, state->current_tick, state->current_stat_tick);
+			}
+			if (state->current_stat_tick > state->board.stat_count) break;
 			i = state->current_stat_tick;
 
-			if (state->board.stats[i].cycle != 0
-				&& (state->current_tick % state->board.stats[i].cycle) == (i % state->board.stats[i].cycle)
-			) {
+			if (zoo_stat_sched_is_due(&state->board, state->current_tick, i)) {
 				// tick self
-				zoo_element_defs[
-					state->board.tiles[state->board.stats[i].x][state->board.stats[i].y].element
-				].tick_func(state, i);
+				ZOO_METRICS_ADD(state, stats_ticked, 1);
+				element = ZOO_TILE(&state->board, state->board.stats[i].x, state->board.stats[i].y).element;
+				ZOO_PROFILE_CALL(state, element_tick, element, i,
+					zoo_element_defs[element].tick_func(state, i));
 
 				// if anything on stack...
 				if (state->call_stack.call != NULL) {
@@ -873,15 +1319,28 @@ GameTickState1:
 			}
 GameTickState2:
 			state->current_stat_tick++;
+			// anything zoo_tick would re-dispatch on ends the batch
+			if (state->game_paused || state->game_play_exit_requested
+				|| state->error_value || state->game_state != game_state) break;
+			if (budget > 0 && (--budget) == 0) break;
+			if (state->oop_frame_budget > 0 && state->oop_frame_ins >= state->oop_frame_budget) {
+				oop_yield = true;
+				break;
+			}
 		}
 	}
 
 	if (state->current_stat_tick > state->board.stat_count) {
+		state->oop_frame_ins = 0;
 		if (zoo_has_hsecs_elapsed(state, &state->tick_counter, state->tick_duration)) {
 			state->current_tick++;
 			if (state->current_tick > 420)
 				state->current_tick = 1;
 			state->current_stat_tick = 0;
+			state->cycle_count++;
+#ifdef ZOO_METRICS
+			zoo_metrics_cycle_end(state);
+#endif
 
 			zoo_input_update(&state->input);
 			zoo_input_clear(&state->input);
@@ -900,6 +1359,13 @@ GameTickState2:
 		return RETURN_NEXT_CYCLE;
 	}
 
+	if (oop_yield) {
+		// continue the cycle on the next frame
+		state->oop_frame_ins = 0;
+		state->oop_frame_yields++;
+		return RETURN_NEXT_FRAME;
+	}
+
 	return RETURN_IMMEDIATE;
 }
 
@@ -910,7 +1376,7 @@ void zoo_tick_advance_pit(zoo_state *state) {
 	}
 }
 
-static ZOO_INLINE zoo_tick_retval zoo_tick_inner(zoo_state *state) {
+static ZOO_INLINE zoo_tick_retval zoo_tick_inner(zoo_state *state, uint16_t budget) {
 	zoo_tick_retval ret;
 
 	ret = zoo_call_stack_tick(state);
@@ -923,7 +1389,7 @@ static ZOO_INLINE zoo_tick_retval zoo_tick_inner(zoo_state *state) {
 			return RETURN_NEXT_CYCLE;
 		case GS_TITLE:
 		case GS_PLAY:
-			return zoo_game_tick(state);
+			return zoo_game_tick(state, budget);
 	}
 }
 
@@ -931,8 +1397,53 @@ zoo_tick_retval zoo_tick(zoo_state *state) {
 	zoo_tick_retval ret;
 
 	if (state->error_value) return ERROR;
-	ret = zoo_tick_inner(state);
+	ret = zoo_tick_inner(state, 1);
+	zoo_video_flush(state);
+	if (state->error_value) return ERROR;
+
+	return ret;
+}
+
+zoo_tick_retval zoo_tick_cycle(zoo_state *state, uint16_t budget) {
+	zoo_tick_retval ret;
+
+	if (state->error_value) return ERROR;
+	ret = zoo_tick_inner(state, budget);
+	zoo_video_flush(state);
 	if (state->error_value) return ERROR;
 
 	return ret;
 }
+
+uint32_t zoo_run_ticks(zoo_state *state, uint32_t n) {
+	uint32_t cycle_start = state->cycle_count;
+	uint32_t yields;
+
+	while ((state->cycle_count - cycle_start) < n) {
+		yields = state->oop_frame_yields;
+		switch (zoo_tick_cycle(state, 0)) {
+			case ERROR:
+				return state->cycle_count - cycle_start;
+			case RETURN_NEXT_FRAME:
+			case RETURN_NEXT_CYCLE:
+				// a waiting call stack entry needs the frontend
+				if (state->call_stack.call != NULL || state->game_state == GS_NONE) {
+					return state->cycle_count - cycle_start;
+				}
+				// an oop_frame_budget yield leaves the cycle half done;
+				// on a virtual clock, the next frame can start right away
+				if (state->oop_frame_yields != yields) {
+					break;
+				}
+				// what a frontend's PIT timer would do
+				zoo_tick_advance_pit(state);
+				zoo_sound_tick(&state->sound);
+				zoo_input_tick(&state->input);
+				break;
+			default:
+				break;
+		}
+	}
+
+	return state->cycle_count - cycle_start;
+}
@@ -25,24 +25,44 @@
 
 #include <stdlib.h>
 #include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define ZOO_RLE_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define ZOO_RLE_NEON
+#endif
 #include "zoo_internal.h"
 
-#define zoo_io_read_byte(h) (h)->func_getc((h))
+// the byte helpers go through the handle's buffer window when they can,
+// and through func_getc/func_putc (which refill or flush it) otherwise
+
+static ZOO_INLINE uint8_t zoo_io_read_byte(zoo_io_handle *h) {
+	if (h->buf_pos < h->buf_read_end)
+		return *(h->buf_pos++);
+	return h->func_getc(h);
+}
 
-static int16_t zoo_io_read_short(zoo_io_handle *h) {
-	uint8_t v = h->func_getc(h);
-	return v | ((uint16_t) h->func_getc(h) << 8);
+static ZOO_INLINE int16_t zoo_io_read_short(zoo_io_handle *h) {
+	uint8_t v;
+	if ((h->buf_read_end - h->buf_pos) >= 2) {
+		v = h->buf_pos[0];
+		h->buf_pos += 2;
+		return v | ((uint16_t) h->buf_pos[-1] << 8);
+	}
+	v = zoo_io_read_byte(h);
+	return v | ((uint16_t) zoo_io_read_byte(h) << 8);
 }
 
-static zoo_tile zoo_io_read_tile(zoo_io_handle *h) {
+static ZOO_INLINE zoo_tile zoo_io_read_tile(zoo_io_handle *h) {
 	zoo_tile tile;
-	tile.element = h->func_getc(h);
-	tile.color = h->func_getc(h);
+	tile.element = zoo_io_read_byte(h);
+	tile.color = zoo_io_read_byte(h);
 	return tile;
 }
 
 static void zoo_io_read_pstring(zoo_io_handle *h, int p_len, char *str, int str_len, bool external) {
-	int len = h->func_getc(h);
+	int len = zoo_io_read_byte(h);
 	if (len > p_len) len = p_len;
 	if (len > str_len) len = str_len;
 	int slen = h->func_read(h, (uint8_t*) str, len);
@@ -51,28 +71,211 @@ static void zoo_io_read_pstring(zoo_io_handle *h, int p_len, char *str, int str_
 	str[slen] = 0;
 }
 
-#define zoo_io_write_byte(h, v) (h)->func_putc((h), (v))
+static ZOO_INLINE void zoo_io_write_byte(zoo_io_handle *h, uint8_t v) {
+	if (h->buf_pos < h->buf_write_end)
+		*(h->buf_pos++) = v;
+	else
+		h->func_putc(h, v);
+}
 
-static void zoo_io_write_short(zoo_io_handle *h, int16_t v) {
-	h->func_putc(h, (v & 0xFF));
-	h->func_putc(h, (v >> 8));
+static ZOO_INLINE void zoo_io_write_short(zoo_io_handle *h, int16_t v) {
+	zoo_io_write_byte(h, (v & 0xFF));
+	zoo_io_write_byte(h, (v >> 8));
 }
 
-static void zoo_io_write_tile(zoo_io_handle *h, zoo_tile tile) {
-	h->func_putc(h, tile.element);
-	h->func_putc(h, tile.color);
+static ZOO_INLINE void zoo_io_write_tile(zoo_io_handle *h, zoo_tile tile) {
+	zoo_io_write_byte(h, tile.element);
+	zoo_io_write_byte(h, tile.color);
 }
 
 static void zoo_io_write_pstring(zoo_io_handle *h, int p_len, const char *str, int str_len, bool external) {
 	str_len = strnlen(str, str_len);
 	if (str_len > p_len) str_len = p_len;
 
-	h->func_putc(h, str_len);
+	zoo_io_write_byte(h, str_len);
 	h->func_write(h, (uint8_t *) str, str_len);
 	if (external)
 		h->func_skip(h, p_len - str_len);
 }
 
+// RLE tile codec
+
+#if ZOO_BOARD_WIDTH > 64
+#error zoo_rle_row_starts needs updating for the new board width
+#endif
+
+#if UINTPTR_MAX > 0xFFFFFFFFUL
+typedef uint64_t zoo_tile_fill_word;
+#define ZOO_TILE_FILL_MUL 0x0001000100010001ULL
+#else
+typedef uint32_t zoo_tile_fill_word;
+#define ZOO_TILE_FILL_MUL 0x00010001UL
+#endif
+
+#define ZOO_TILE_FILL_STEP ((int16_t) (sizeof(zoo_tile_fill_word) / sizeof(zoo_tile)))
+
+// number of runs the encoder collects before each func_write
+#define ZOO_RLE_WRITE_RUNS 64
+
+// word holds the tile repeated ZOO_TILE_FILL_STEP times, in memory order
+static ZOO_INLINE void zoo_tile_fill(zoo_tile *dst, zoo_tile_fill_word word, int16_t count) {
+	for (; count >= ZOO_TILE_FILL_STEP; count -= ZOO_TILE_FILL_STEP, dst += ZOO_TILE_FILL_STEP)
+		memcpy(dst, &word, sizeof(word));
+	for (; count > 0; count--, dst++)
+		memcpy(dst, &word, sizeof(zoo_tile));
+}
+
+static void zoo_io_read_tiles(zoo_io_handle *h, zoo_board *board) {
+	zoo_tile *tile;
+	zoo_tile_fill_word word;
+	const uint8_t *src;
+	uint8_t run_data[3];
+	uint16_t pair;
+	int16_t iy, run, left;
+
+	tile = &ZOO_TILE(board, 1, 1);
+	left = ZOO_BOARD_WIDTH;
+	for (iy = 1; ; ) {
+		// take the run straight from the buffer window if it is all there
+		if ((h->buf_read_end - h->buf_pos) >= 3) {
+			src = h->buf_pos;
+			h->buf_pos += 3;
+		} else {
+			run_data[0] = zoo_io_read_byte(h);
+			run_data[1] = zoo_io_read_byte(h);
+			run_data[2] = zoo_io_read_byte(h);
+			src = run_data;
+		}
+
+		// a count of 0 places 256 tiles
+		run = src[0] == 0 ? 256 : src[0];
+		// element and color bytes are laid out as in zoo_tile
+		memcpy(&pair, src + 1, sizeof(pair));
+		word = pair * ZOO_TILE_FILL_MUL;
+
+		// fill the run a row segment at a time
+		while (run >= left) {
+			zoo_tile_fill(tile, word, left);
+			run -= left;
+			if (++iy > ZOO_BOARD_HEIGHT)
+				return;
+			tile += left + 2;
+			left = ZOO_BOARD_WIDTH;
+		}
+		if (run <= ZOO_TILE_FILL_STEP && left >= ZOO_TILE_FILL_STEP) {
+			// short run: one word store, the excess is overwritten by
+			// the runs that follow
+			zoo_tile_fill(tile, word, ZOO_TILE_FILL_STEP);
+		} else {
+			zoo_tile_fill(tile, word, run);
+		}
+		tile += run;
+		left -= run;
+	}
+}
+
+// Returns a mask of the tiles in row iy (bit ix - 1) which differ from the
+// tile before them in board order, and so start a new run.
+static ZOO_INLINE uint64_t zoo_rle_row_starts(zoo_board *board, int16_t iy) {
+	const zoo_tile *row = &ZOO_TILE(board, 1, iy);
+	const zoo_tile *prev;
+	uint64_t mask = 0;
+	int16_t ix;
+#if defined(ZOO_RLE_SSE2)
+	__m128i eq;
+#elif defined(ZOO_RLE_NEON)
+	static const uint16_t lane_bits[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+	uint16x8_t bits = vld1q_u16(lane_bits);
+	uint16x8_t eq;
+#endif
+
+#if defined(ZOO_RLE_SSE2) || defined(ZOO_RLE_NEON)
+	// eight tiles against their left neighbours at a time; row[-1] is the
+	// board edge, and the last block reads into the next row - both are
+	// masked off below
+	for (ix = 0; ix < ZOO_BOARD_WIDTH; ix += 8) {
+#if defined(ZOO_RLE_SSE2)
+		eq = _mm_cmpeq_epi16(
+			_mm_loadu_si128((const __m128i *) (row + ix)),
+			_mm_loadu_si128((const __m128i *) (row + ix - 1))
+		);
+		mask |= (uint64_t) (~_mm_movemask_epi8(_mm_packs_epi16(eq, eq)) & 0xFF) << ix;
+#else
+		eq = vceqq_u16(
+			vreinterpretq_u16_u8(vld1q_u8((const uint8_t *) (row + ix))),
+			vreinterpretq_u16_u8(vld1q_u8((const uint8_t *) (row + ix - 1)))
+		);
+		mask |= (uint64_t) vaddvq_u16(vbicq_u16(bits, eq)) << ix;
+#endif
+	}
+	mask &= (((uint64_t) 1 << ZOO_BOARD_WIDTH) - 1) & ~((uint64_t) 1);
+#else
+	for (ix = 1; ix < ZOO_BOARD_WIDTH; ix++) {
+		if (row[ix].element != row[ix - 1].element || row[ix].color != row[ix - 1].color)
+			mask |= (uint64_t) 1 << ix;
+	}
+#endif
+
+	// the first tile continues the run from the end of the previous row
+	prev = &ZOO_TILE(board, ZOO_BOARD_WIDTH, iy - 1);
+	if (iy == 1 || row[0].element != prev->element || row[0].color != prev->color)
+		mask |= 1;
+
+	return mask;
+}
+
+static ZOO_INLINE int zoo_ctz64(uint64_t v) {
+	return ((uint32_t) v) != 0 ? zoo_ctz32((uint32_t) v) : (32 + zoo_ctz32((uint32_t) (v >> 32)));
+}
+
+// Appends a run, split into counts of at most 255, to buf; flushes buf when
+// it fills up. Returns the new position in buf.
+static ZOO_INLINE size_t zoo_rle_put_run(zoo_io_handle *h, uint8_t *buf, size_t pos, int16_t count, zoo_tile tile) {
+	while (count > 0) {
+		buf[pos++] = count > 255 ? 255 : count;
+		buf[pos++] = tile.element;
+		buf[pos++] = tile.color;
+		count -= 255;
+
+		if (pos >= ZOO_RLE_WRITE_RUNS * 3) {
+			h->func_write(h, buf, pos);
+			pos = 0;
+		}
+	}
+
+	return pos;
+}
+
+static void zoo_io_write_tiles(zoo_io_handle *h, zoo_board *board) {
+	uint8_t buf[ZOO_RLE_WRITE_RUNS * 3];
+	size_t buf_pos = 0;
+	zoo_tile run_tile;
+	int16_t run_len, ix, iy, start;
+	uint64_t starts;
+
+	run_tile = ZOO_TILE(board, 1, 1);
+	run_len = 0;
+	for (iy = 1; iy <= ZOO_BOARD_HEIGHT; iy++) {
+		starts = zoo_rle_row_starts(board, iy);
+		ix = 0;
+		while (starts != 0) {
+			start = zoo_ctz64(starts);
+			starts &= starts - 1;
+
+			run_len += start - ix;
+			buf_pos = zoo_rle_put_run(h, buf, buf_pos, run_len, run_tile);
+			run_tile = ZOO_TILE(board, start + 1, iy);
+			run_len = 0;
+			ix = start;
+		}
+		run_len += ZOO_BOARD_WIDTH - ix;
+	}
+
+	buf_pos = zoo_rle_put_run(h, buf, buf_pos, run_len, run_tile);
+	if (buf_pos > 0)
+		h->func_write(h, buf, buf_pos);
+}
+
 static void zoo_io_stat_read(zoo_io_handle *h, zoo_stat *stat) {
 	stat->x = zoo_io_read_byte(h);
 	stat->y = zoo_io_read_byte(h);
@@ -109,7 +312,40 @@ static void zoo_io_stat_write(zoo_io_handle *h, zoo_stat *stat) {
 	h->func_skip(h, 8);
 }
 
-static void zoo_io_packed_stat_read(zoo_io_handle *h, zoo_stat *stat) {
+// Writes a stat's code as ZZT expects it. Without object code writes,
+// #zap and #restore only change the label cache (and label_cache_chr2), so
+// they are applied to the written copy instead.
+static void zoo_io_stat_data_write(zoo_io_handle *h, zoo_stat *stat) {
+#ifdef ZOO_NO_OBJECT_CODE_WRITES
+	const uint8_t *data = (const uint8_t *) stat->data;
+	int16_t pos = 0, label_pos;
+	int ix;
+
+	if (stat->label_cache_chr2 != 0 && stat->data_len > 1) {
+		zoo_io_write_byte(h, data[0]);
+		zoo_io_write_byte(h, stat->label_cache_chr2);
+		pos = 2;
+	}
+	for (ix = 0; ix < stat->label_cache_size - 1; ix++) {
+		// the label's ':' follows its line break
+		label_pos = stat->label_cache[ix].pos + 1;
+		if (label_pos < pos)
+			continue;
+		if (label_pos >= stat->data_len)
+			break;
+		h->func_write(h, data + pos, label_pos - pos);
+		zoo_io_write_byte(h, stat->label_cache[ix].zapped ? '\'' : ':');
+		pos = label_pos + 1;
+	}
+	h->func_write(h, data + pos, stat->data_len - pos);
+#else
+	h->func_write(h, (uint8_t *) stat->data, stat->data_len);
+#endif
+}
+
+// Returns true if the stat's code is a copy-on-write clone of the code of
+// stat -data_len, rather than bound to it.
+static bool zoo_io_packed_stat_read(zoo_io_handle *h, zoo_stat *stat) {
 	uint8_t flags = zoo_io_read_byte(h);
 
 	stat->x = zoo_io_read_byte(h);
@@ -134,7 +370,9 @@ static void zoo_io_packed_stat_read(zoo_io_handle *h, zoo_stat *stat) {
 	stat->under = zoo_io_read_tile(h);
 	if (flags & 0x04) {
 #ifdef ZOO_USE_ROM_POINTERS
-		h->func_read(h, &stat->data, 4);
+		// 0x40: the code is not in ROM, and follows the stat as usual
+		if (!(flags & 0xC0))
+			h->func_read(h, (uint8_t *) &stat->data, sizeof(stat->data));
 #endif
 		stat->data_pos = zoo_io_read_short(h);
 		stat->data_len = zoo_io_read_short(h);
@@ -144,9 +382,10 @@ static void zoo_io_packed_stat_read(zoo_io_handle *h, zoo_stat *stat) {
 		stat->label_cache_chr2 = zoo_io_read_byte(h);
 	}
 #endif
+	return (flags & 0x80) != 0;
 }
 
-static void zoo_io_packed_stat_write(zoo_io_handle *h, zoo_stat *stat) {
+static void zoo_io_packed_stat_write(zoo_io_handle *h, zoo_stat *stat, bool data_copy) {
 	uint8_t flags = 0;
 	if (stat->step_x != 0 || stat->step_y != 0) flags |= 0x01;
 	if (stat->follower != -1 || stat->leader != -1) flags |= 0x02;
@@ -156,6 +395,10 @@ static void zoo_io_packed_stat_write(zoo_io_handle *h, zoo_stat *stat) {
 #ifdef ZOO_NO_OBJECT_CODE_WRITES
 	if (stat->label_cache_chr2 != 0) flags |= 0x20;
 #endif
+#ifdef ZOO_USE_ROM_POINTERS
+	if (stat->data_len > 0 && !platform_is_rom_ptr(stat->data)) flags |= 0x40;
+#endif
+	if (data_copy) flags |= 0x80;
 
 	zoo_io_write_byte(h, flags);
 
@@ -182,7 +425,8 @@ static void zoo_io_packed_stat_write(zoo_io_handle *h, zoo_stat *stat) {
 	zoo_io_write_tile(h, stat->under);
 	if (flags & 0x04) {
 #ifdef ZOO_USE_ROM_POINTERS
-		h->func_write(h, &stat->data, 4);
+		if (!(flags & 0xC0))
+			h->func_write(h, (uint8_t *) &stat->data, sizeof(stat->data));
 #endif
 		zoo_io_write_short(h, stat->data_pos);
 		zoo_io_write_short(h, stat->data_len);
@@ -213,47 +457,44 @@ size_t zoo_io_board_max_length(zoo_board *board) {
 		if (board->stats[ix].data_len > 0)
 			size += board->stats[ix].label_cache_size * 3;
 #endif
-#ifndef ZOO_USE_ROM_POINTERS
-		if (board->stats[ix].data_len > 0)
+		if (board->stats[ix].data_len > 0 && !platform_is_rom_ptr(board->stats[ix].data))
 			size += board->stats[ix].data_len;
-#endif
 	}
 
 	return size;
 }
 
-static int zoo_io_board_write_internal(zoo_io_handle *h, zoo_board *board, bool external) {
+// Returns the stat whose object code stat_id shares (#BIND), or 0 if it owns
+// its code; matches the data_len = -iy encoding of the board writer.
+static int16_t zoo_stat_data_owner(zoo_stat *stats, int16_t stat_id) {
+	int16_t i, owner = 0;
+
+	for (i = 1; i < stat_id; i++) {
+		if (zoo_stat_data_bound(&stats[i], &stats[stat_id]))
+			owner = i;
+	}
+
+	return owner;
+}
+
+// Frees the object code owned by a stat list. Going backwards keeps the
+// reference counts zoo_stat_data_owner looks at intact.
+static void zoo_stats_free_data(zoo_stat *stats, int16_t stat_count) {
+	int16_t i;
+
+	for (i = stat_count; i >= 0; i--) {
+		if (stats[i].data_len != 0 && zoo_stat_data_owner(stats, i) == 0)
+			zoo_stat_free(&stats[i]);
+	}
+}
+
+static int zoo_io_board_write_internal(zoo_io_handle *h, zoo_board *board, bool external, bool free_data) {
 	int ix, iy;
-	zoo_rle_tile rle;
 	zoo_stat *stat;
+	bool data_copy;
 
 	zoo_io_write_pstring(h, 50, board->name, sizeof(board->name) - 1, external);
-
-	ix = 1;
-	iy = 1;
-	rle.count = 1;
-	rle.tile = board->tiles[ix][iy];
-	do {
-		ix++;
-		if (ix > ZOO_BOARD_WIDTH) {
-			ix = 1;
-			iy++;
-		}
-
-		if (
-			(board->tiles[ix][iy].color == rle.tile.color)
-			&& (board->tiles[ix][iy].element == rle.tile.element)
-			&& (rle.count < 255)
-			&& (iy <= ZOO_BOARD_HEIGHT)
-		) {
-			rle.count++;
-		} else {
-			zoo_io_write_byte(h, rle.count);
-			zoo_io_write_tile(h, rle.tile);
-			rle.tile = board->tiles[ix][iy];
-			rle.count = 1;
-		}
-	} while (iy <= ZOO_BOARD_HEIGHT);
+	zoo_io_write_tiles(h, board);
 
 	zoo_io_write_byte(h, board->info.max_shots);
 	zoo_io_write_byte(h, board->info.is_dark);
@@ -270,69 +511,60 @@ static int zoo_io_board_write_internal(zoo_io_handle *h, zoo_board *board, bool
 	zoo_io_write_short(h, board->stat_count);
 	stat = &board->stats[0];
 	for (ix = 0; ix <= board->stat_count; ix++, stat++) {
+		data_copy = false;
 		if (stat->data_len > 0) {
 			for (iy = 1; iy < ix; iy++) {
 				if (board->stats[iy].data == stat->data) {
+					// ZZT has no notion of copy-on-write clones
+					data_copy = zoo_stat_data_shared(stat->data);
+					if (data_copy && external) continue;
 					stat->data_len = -iy;
 				}
 			}
 		}
 
 		if (external) zoo_io_stat_write(h, stat);
-		else zoo_io_packed_stat_write(h, stat);
+		else zoo_io_packed_stat_write(h, stat, data_copy && stat->data_len < 0);
 
-		if (stat->data_len > 0) {
+		if (stat->data_len > 0 || (data_copy && !external)) {
 			if (!external) {
-#ifndef ZOO_USE_ROM_POINTERS
-				h->func_write(h, (uint8_t *) stat->data, stat->data_len);
-#endif
+				if (stat->data_len > 0 && !platform_is_rom_ptr(stat->data))
+					h->func_write(h, (uint8_t *) stat->data, stat->data_len);
 #ifdef ZOO_STORE_LABEL_CACHE
+				// label_cache_size is the label count plus one
 				zoo_io_write_short(h, stat->label_cache_size);
-				for (iy = 0; iy < stat->label_cache_size; iy++) {
+				for (iy = 0; iy < stat->label_cache_size - 1; iy++) {
 					zoo_io_write_short(h, stat->label_cache[iy].pos);
 					zoo_io_write_byte(h, stat->label_cache[iy].zapped);
 				}
 #endif
 			} else {
-				h->func_write(h, (uint8_t *) stat->data, stat->data_len);
+				zoo_io_stat_data_write(h, stat);
 			}
-			zoo_stat_free(stat);
 		}
 	}
 
+	// clones share code until freed, so this waits until all are written
+	if (free_data)
+		zoo_stats_free_data(board->stats, board->stat_count);
+
 	return 0;
 }
 
 int zoo_io_board_write(zoo_io_handle *h, zoo_board *board) {
-	return zoo_io_board_write_internal(h, board, true);
+	return zoo_io_board_write_internal(h, board, true, true);
 }
 
 static int zoo_io_board_read_internal(zoo_io_handle *h, zoo_board *board, bool external) {
 	int ix, iy;
-	zoo_rle_tile rle;
 	zoo_stat *stat;
+	bool data_copy = false, data_bound;
 #ifdef ZOO_USE_ROM_POINTERS
 	bool is_rom = h->func_getptr != NULL && platform_is_rom_ptr(h->func_getptr(h));
 #endif
 
 	zoo_io_read_pstring(h, 50, board->name, sizeof(board->name) - 1, external);
-
-	ix = 1;
-	iy = 1;
-	rle.count = 0;
-	do {
-		if (rle.count <= 0) {
-			rle.count = zoo_io_read_byte(h);
-			rle.tile = zoo_io_read_tile(h);
-		}
-		board->tiles[ix][iy] = rle.tile;
-		ix++;
-		if (ix > ZOO_BOARD_WIDTH) {
-			ix = 1;
-			iy++;
-		}
-		rle.count--;
-	} while (iy <= ZOO_BOARD_HEIGHT);
+	zoo_io_read_tiles(h, board);
 
 	board->info.max_shots = zoo_io_read_byte(h);
 	board->info.is_dark = zoo_io_read_byte(h);
@@ -358,49 +590,60 @@ static int zoo_io_board_read_internal(zoo_io_handle *h, zoo_board *board, bool e
 		zoo_stat_clear(stat);
 
 		if (external) zoo_io_stat_read(h, stat);
-		else zoo_io_packed_stat_read(h, stat);
+		else data_copy = zoo_io_packed_stat_read(h, stat);
 
-		if (stat->data_len > 0) {
+		data_bound = stat->data_len < 0 && !data_copy;
+		if (stat->data_len < 0) {
+			// TODO: bounds check
+			if (data_copy)
+				stat->data = zoo_stat_data_ref(board->stats[-stat->data_len].data);
+			else
+				stat->data = board->stats[-stat->data_len].data;
+			stat->data_len = board->stats[-stat->data_len].data_len;
+		} else if (stat->data_len > 0) {
 #ifdef ZOO_USE_ROM_POINTERS
 			if (is_rom) {
 				stat->data = (char*) h->func_getptr(h);
-				h->func_skip(h, stat->data_len);
-			} else if (!external) {
+				stat->data_len = h->func_skip(h, stat->data_len);
+			} else if (!external && stat->data != NULL) {
 				// If not from external ROM, stat->data should be correct,
 				// and there should be no text following.
 			} else {
-				stat->data = malloc(stat->data_len);
+				stat->data = zoo_stat_data_alloc(stat->data_len);
+				ZOO_BOARD_METRICS_MALLOC(board);
 				if (stat->data == NULL)
 					return ZOO_ERROR_NOMEM;
 				h->func_read(h, (uint8_t *) stat->data, stat->data_len);
 			}
 #else
-			stat->data = malloc(stat->data_len);
+			stat->data = zoo_stat_data_alloc(stat->data_len);
+			ZOO_BOARD_METRICS_MALLOC(board);
 			if (stat->data == NULL)
 				return ZOO_ERROR_NOMEM;
 			h->func_read(h, (uint8_t *) stat->data, stat->data_len);
 #endif
+		}
+
 #ifdef ZOO_STORE_LABEL_CACHE
-			if (!external) {
-				stat->label_cache_size = zoo_io_read_short(h);
-				if (stat->label_cache_size > 0) {
-					stat->label_cache = malloc(sizeof(zoo_stat_label) * stat->label_cache_size);
-					if (stat->label_cache == NULL)
-						return ZOO_ERROR_NOMEM;
-				}
-				for (iy = 0; iy < stat->label_cache_size; iy++) {
+		if (!external && stat->data_len > 0 && !data_bound) {
+			stat->label_cache_size = zoo_io_read_short(h);
+			if (stat->label_cache_size > 1) {
+				stat->label_cache = malloc(zoo_oop_label_cache_bytes(stat->label_cache_size - 1));
+				ZOO_BOARD_METRICS_MALLOC(board);
+				if (stat->label_cache == NULL)
+					return ZOO_ERROR_NOMEM;
+				for (iy = 0; iy < stat->label_cache_size - 1; iy++) {
 					stat->label_cache[iy].pos = zoo_io_read_short(h);
 					stat->label_cache[iy].zapped = zoo_io_read_byte(h);
 				}
+				// name hashes are not stored; the code is at hand
+				zoo_oop_label_cache_index(stat);
 			}
-#endif
-		} else if (stat->data_len < 0) {
-			// TODO: bounds check
-			stat->data = board->stats[-stat->data_len].data;
-			stat->data_len = board->stats[-stat->data_len].data_len;
 		}
+#endif
 	}
 
+	zoo_stat_index_build(board);
 	return 0;
 }
 
@@ -408,14 +651,213 @@ int zoo_io_board_read(zoo_io_handle *h, zoo_board *board) {
 	return zoo_io_board_read_internal(h, board, true);
 }
 
-static int zoo_board_close_internal(zoo_state *state, bool external) {
+// Board cache: entries hold a closed board in the form zoo_board_open would
+// decode it to, and own its object code until reopened or evicted.
+
+struct s_zoo_board_cache_entry {
+	struct s_zoo_board_cache_entry *prev, *next;
+	size_t size;
+	int16_t board_id;
+	int16_t stat_count;
+	char name[51];
+	zoo_board_info info;
+	zoo_tile tiles[ZOO_BOARD_HEIGHT][ZOO_BOARD_WIDTH];
+	zoo_stat stats[];
+};
+
+typedef struct s_zoo_board_cache_entry zoo_board_cache_entry;
+
+static void zoo_board_cache_unlink(zoo_state *state, zoo_board_cache_entry *entry) {
+	if (entry->prev != NULL)
+		entry->prev->next = entry->next;
+	else
+		state->board_cache_head = entry->next;
+
+	if (entry->next != NULL)
+		entry->next->prev = entry->prev;
+	else
+		state->board_cache_tail = entry->prev;
+
+	state->board_cache_size -= entry->size;
+}
+
+static void zoo_board_cache_evict(zoo_state *state, zoo_board_cache_entry *entry) {
+	zoo_board_cache_unlink(state, entry);
+	zoo_stats_free_data(entry->stats, entry->stat_count);
+	free(entry);
+}
+
+static void zoo_board_cache_trim(zoo_state *state, size_t limit) {
+	while (state->board_cache_tail != NULL && state->board_cache_size > limit) {
+		zoo_board_cache_evict(state, state->board_cache_tail);
+	}
+}
+
+void zoo_board_cache_set_limit(zoo_state *state, size_t limit) {
+	state->board_cache_limit = limit;
+	zoo_board_cache_trim(state, limit);
+}
+
+void zoo_board_cache_clear(zoo_state *state) {
+	zoo_board_cache_trim(state, 0);
+}
+
+// Copies the current board into a new cache entry, which takes over its
+// object code. Returns false if the board was not cached.
+static bool zoo_board_cache_store(zoo_state *state, int16_t board_id) {
+	zoo_board *board = &state->board;
+	zoo_board_cache_entry *entry;
+	zoo_stat *stat;
+	size_t size;
+	int16_t ix, owner;
+
+	size = sizeof(zoo_board_cache_entry) + sizeof(zoo_stat) * (board->stat_count + 1);
+	for (ix = 0; ix <= board->stat_count; ix++) {
+		stat = &board->stats[ix];
+		if (stat->data_len > 0 && zoo_stat_data_owner(board->stats, ix) == 0) {
+			if (!platform_is_rom_ptr(stat->data))
+				size += stat->data_len;
+#ifdef ZOO_USE_OOP_CACHE
+			size += zoo_oop_cache_bytes(stat->data);
+#endif
+#ifdef ZOO_STORE_LABEL_CACHE
+			if (stat->label_cache_size > 1)
+				size += zoo_oop_label_cache_bytes(stat->label_cache_size - 1);
+#endif
+		}
+	}
+
+	if (size > state->board_cache_limit)
+		return false;
+
+	entry = malloc(size);
+	ZOO_METRICS_ADD(state, mallocs, 1);
+	if (entry == NULL)
+		return false;
+
+	entry->size = size;
+	entry->board_id = board_id;
+	entry->stat_count = board->stat_count;
+	memcpy(entry->name, board->name, sizeof(entry->name));
+	entry->info = board->info;
+	for (ix = 0; ix < ZOO_BOARD_HEIGHT; ix++)
+		memcpy(entry->tiles[ix], &ZOO_TILE(board, 1, ix + 1), sizeof(entry->tiles[ix]));
+	memcpy(entry->stats, board->stats, sizeof(zoo_stat) * (board->stat_count + 1));
+
+	// drop whatever the board format does not keep
+	for (ix = 0; ix <= entry->stat_count; ix++) {
+		stat = &entry->stats[ix];
+		owner = zoo_stat_data_owner(board->stats, ix);
+
+		if (stat->data_len == 0) {
+			stat->data = NULL;
+			stat->data_pos = 0;
+		} else if (stat->data_len > 0 && owner != 0) {
+			stat->data_len = entry->stats[owner].data_len;
+		}
+
+#ifdef ZOO_USE_LABEL_CACHE
+		if (stat->data_len > 0 && owner == 0) {
+#ifndef ZOO_STORE_LABEL_CACHE
+			if (stat->label_cache_size > 0)
+				free(stat->label_cache);
+			stat->label_cache = NULL;
+			stat->label_cache_size = 0;
+#endif
+		} else {
+			stat->label_cache = NULL;
+			stat->label_cache_size = 0;
+		}
+#endif
+	}
+
+	entry->prev = NULL;
+	entry->next = state->board_cache_head;
+	if (entry->next != NULL)
+		entry->next->prev = entry;
+	else
+		state->board_cache_tail = entry;
+	state->board_cache_head = entry;
+	state->board_cache_size += size;
+
+	// size <= limit, so this never evicts the new entry
+	zoo_board_cache_trim(state, state->board_cache_limit);
+	return true;
+}
+
+// Moves a cached board back into the current board, if present.
+static bool zoo_board_cache_fetch(zoo_state *state, int16_t board_id) {
+	zoo_board *board = &state->board;
+	zoo_board_cache_entry *entry;
+	int16_t ix;
+
+	for (entry = state->board_cache_head; entry != NULL; entry = entry->next) {
+		if (entry->board_id == board_id)
+			break;
+	}
+	if (entry == NULL)
+		return false;
+
+	zoo_board_cache_unlink(state, entry);
+
+	memcpy(board->name, entry->name, sizeof(entry->name));
+	board->info = entry->info;
+	for (ix = 0; ix < ZOO_BOARD_HEIGHT; ix++)
+		memcpy(&ZOO_TILE(board, 1, ix + 1), entry->tiles[ix], sizeof(entry->tiles[ix]));
+	board->stat_count = entry->stat_count;
+	memcpy(board->stats, entry->stats, sizeof(zoo_stat) * (entry->stat_count + 1));
+	free(entry);
+
+	zoo_stat_index_build(board);
+	return true;
+}
+
+#ifdef ZOO_USE_BOARD_SNAPSHOT
+// Takes the copies zoo_board_modified compares against.
+static void zoo_board_mark_clean(zoo_board *board) {
+	int16_t i;
+
+	board->dirty = false;
+	board->saved_stat_count = board->stat_count;
+	memcpy(&board->saved_info, &board->info, sizeof(zoo_board_info));
+	for (i = 0; i <= board->stat_count; i++)
+		memcpy(board->saved_stats[i], &board->stats[i], ZOO_STAT_SAVED_SIZE);
+}
+
+static bool zoo_board_modified(zoo_board *board) {
+	int16_t i;
+
+	if (board->dirty || board->stat_count != board->saved_stat_count
+		|| memcmp(&board->info, &board->saved_info, sizeof(zoo_board_info)))
+		return true;
+	for (i = 0; i <= board->stat_count; i++) {
+		if (memcmp(board->saved_stats[i], &board->stats[i], ZOO_STAT_SAVED_SIZE))
+			return true;
+	}
+	return false;
+}
+#else
+// Without the snapshot, every board is re-encoded on close.
+#define zoo_board_mark_clean(board)
+#define zoo_board_modified(board) true
+#endif
+
+static int zoo_board_close_internal(zoo_state *state, bool external, bool cache) {
 	zoo_io_handle handle;
 	int16_t board_id;
 	size_t buf_len;
 	int ret;
 	uint8_t *new_ptr;
 
+	ZOO_METRICS_ADD(state, board_closes, 1);
 	board_id = state->world.info.current_board;
+	if (cache && !zoo_board_modified(&state->board) && state->world.board_data[board_id] != NULL) {
+		// board_data is still up to date
+		if (state->board_cache_limit == 0 || !zoo_board_cache_store(state, board_id))
+			zoo_stats_free_data(state->board.stats, state->board.stat_count);
+		return 0;
+	}
+
 	if (state->world.board_data[board_id] != NULL) {
 		if (!platform_is_rom_ptr(state->world.board_data[board_id]))
 			free(state->world.board_data[board_id]);
@@ -424,13 +866,20 @@ static int zoo_board_close_internal(zoo_state *state, bool external) {
 
 	buf_len = 1 + zoo_io_board_max_length(&state->board);
 	state->world.board_data[board_id] = malloc(buf_len);
+	ZOO_METRICS_ADD(state, mallocs, 1);
 	if (state->world.board_data[board_id] == NULL)
 		return ZOO_ERROR_NOMEM;
 
+	if (cache && state->board_cache_limit > 0)
+		cache = zoo_board_cache_store(state, board_id);
+	else
+		cache = false;
+
 	handle = zoo_io_open_file_mem(state->world.board_data[board_id], buf_len, true);
 
-	ret = zoo_io_board_write_internal(&handle, &state->board, external);
+	ret = zoo_io_board_write_internal(&handle, &state->board, external, !cache);
 	if (ret) return ret;
+	ZOO_METRICS_ADD(state, board_bytes_encoded, handle.func_tell(&handle));
 
 	state->world.board_external[board_id] = external;
 
@@ -444,37 +893,45 @@ static int zoo_board_close_internal(zoo_state *state, bool external) {
 	return 0;
 }
 
-int zoo_board_close(zoo_state *state) {
-	return zoo_board_close_internal(state, false);
-}
-
-int zoo_board_open(zoo_state *state, int16_t board_id) {
+static int zoo_board_open_internal(zoo_state *state, int16_t board_id, bool cache) {
 	zoo_io_handle handle;
 	int ret;
-	int external;
 
 	if (board_id > state->world.board_count) {
 		board_id = state->world.info.current_board;
 	}
+	ZOO_METRICS_ADD(state, board_opens, 1);
 
-	handle = zoo_io_open_file_mem(
-		state->world.board_data[board_id],
-		state->world.board_len[board_id],
-		false
-	);
+	if (!cache || !zoo_board_cache_fetch(state, board_id)) {
+		handle = zoo_io_open_file_mem(
+			state->world.board_data[board_id],
+			state->world.board_len[board_id],
+			false
+		);
 
-	ret = zoo_io_board_read_internal(&handle, &state->board, state->world.board_external[board_id]);
-	if (ret) return ret;
+		ret = zoo_io_board_read_internal(&handle, &state->board, state->world.board_external[board_id]);
+		if (ret) return ret;
+	}
 
+	zoo_board_mark_clean(&state->board);
 	state->world.info.current_board = board_id;
 	return 0;
 }
 
+int zoo_board_close(zoo_state *state) {
+	return zoo_board_close_internal(state, false, true);
+}
+
+int zoo_board_open(zoo_state *state, int16_t board_id) {
+	return zoo_board_open_internal(state, board_id, true);
+}
+
 int zoo_world_close(zoo_state *state) {
 	int i;
 
-	i = zoo_board_close(state);
-	if (i) return i;
+	// the world is being discarded, so there is no need to write the board back
+	zoo_board_cache_clear(state);
+	zoo_stats_free_data(state->board.stats, state->board.stat_count);
 
 	for (i = 0; i <= state->world.board_count; i++) {
 		if (!platform_is_rom_ptr(state->world.board_data[i]))
@@ -482,6 +939,13 @@ int zoo_world_close(zoo_state *state) {
 		state->world.board_data[i] = NULL;
 	}
 
+#ifdef ZOO_USE_ROM_POINTERS
+	if (state->world.rom_release != NULL) {
+		state->world.rom_release(state->world.rom_release_arg);
+		state->world.rom_release = NULL;
+	}
+#endif
+
 	return 0;
 }
 
@@ -489,6 +953,10 @@ int zoo_io_world_read(zoo_io_handle *h, zoo_world *world, bool title_only) {
 	int i;
 #ifdef ZOO_USE_ROM_POINTERS
 	bool is_rom = h->func_getptr != NULL && platform_is_rom_ptr(h->func_getptr(h));
+
+	world->rom_release = NULL;
+	if (is_rom && h->func_retain != NULL)
+		world->rom_release = h->func_retain(h, &world->rom_release_arg);
 #endif
 
 	world->board_count = zoo_io_read_short(h);
@@ -533,7 +1001,7 @@ int zoo_io_world_read(zoo_io_handle *h, zoo_world *world, bool title_only) {
 #ifdef ZOO_USE_ROM_POINTERS
 		if (is_rom) {
 			world->board_data[i] = h->func_getptr(h);
-			h->func_skip(h, world->board_len[i]);
+			world->board_len[i] = h->func_skip(h, world->board_len[i]);
 			continue;
 		}
 #endif
@@ -550,8 +1018,8 @@ int zoo_io_world_read(zoo_io_handle *h, zoo_world *world, bool title_only) {
 static void zoo_resave_board(int i, zoo_world *world, bool external) {
 	zoo_state state;
 	memcpy(&state.world, world, sizeof(zoo_world));
-	zoo_board_open(&state, i);
-	zoo_board_close_internal(&state, external);
+	zoo_board_open_internal(&state, i, false);
+	zoo_board_close_internal(&state, external, false);
 	memcpy(world, &state.world, sizeof(zoo_world));
 }
 
@@ -28,6 +28,7 @@
 #ifndef __ZOO_INTERNAL_H__
 #define __ZOO_INTERNAL_H__
 
+#include <stddef.h>
 #include "zoo.h"
 
 // platform/compiler-specific hacks
@@ -50,6 +51,19 @@
 #define GBA_FAST_CODE
 #endif
 
+static ZOO_INLINE int zoo_ctz32(uint32_t v) {
+#ifdef __GNUC__
+	return __builtin_ctz(v);
+#else
+	int i = 0;
+	while (!(v & 1)) {
+		v >>= 1;
+		i++;
+	}
+	return i;
+#endif
+}
+
 #ifdef ZOO_USE_ROM_POINTERS
 // Global function.
 bool platform_is_rom_ptr(void *ptr);
@@ -58,6 +72,14 @@ bool platform_is_rom_ptr(void *ptr);
 #define platform_is_rom_ptr(ptr) 0
 #endif
 
+// zoo.c
+
+#ifdef ZOO_USE_VIDEO_BATCH
+#define ZOO_VIDEO_BATCHED(d_video) ((d_video)->func_write_span != NULL || (d_video)->func_write_rect != NULL)
+#else
+#define ZOO_VIDEO_BATCHED(d_video) false
+#endif
+
 // zoo_element.c
 
 extern const zoo_element_def zoo_element_defs[ZOO_MAX_ELEMENT + 1];
@@ -72,13 +94,179 @@ extern const int16_t zoo_diagonal_delta_x[8];
 extern const int16_t zoo_diagonal_delta_y[8];
 extern const int16_t zoo_neighbor_delta_x[4];
 extern const int16_t zoo_neighbor_delta_y[4];
+extern const uint32_t zoo_torch_stencil[ZOO_TORCH_DY * 2 + 1];
+
+#define ZOO_TORCH_LIT(dx, dy) ( \
+	zoo_abs(dx) <= ZOO_TORCH_DX && zoo_abs(dy) <= ZOO_TORCH_DY \
+	&& (zoo_torch_stencil[(dy) + ZOO_TORCH_DY] & (1UL << ((dx) + ZOO_TORCH_DX))) \
+)
+
+#ifdef ZOO_USE_ELEMENT_INDEX
+void zoo_element_index_update(zoo_board *board, int16_t x, int16_t y, uint8_t old_element, uint8_t new_element);
+bool zoo_element_index_next(zoo_board *board, uint8_t element, int16_t *x, int16_t *y);
+#endif
+
+#ifdef ZOO_USE_BOARD_SNAPSHOT
+#define ZOO_BOARD_MARK_DIRTY(board) ((board)->dirty = true)
+#else
+#define ZOO_BOARD_MARK_DIRTY(board)
+#endif
+
+// all tile writes to a loaded board go through these; they only mark the
+// board dirty if the tile actually changes
+static ZOO_INLINE void zoo_board_set_element(zoo_board *board, int16_t x, int16_t y, uint8_t element) {
+	if (ZOO_TILE(board, x, y).element == element)
+		return;
+#ifdef ZOO_USE_ELEMENT_INDEX
+	zoo_element_index_update(board, x, y, ZOO_TILE(board, x, y).element, element);
+#endif
+	ZOO_TILE(board, x, y).element = element;
+	ZOO_BOARD_MARK_DIRTY(board);
+}
+
+static ZOO_INLINE void zoo_board_set_color(zoo_board *board, int16_t x, int16_t y, uint8_t color) {
+	if (ZOO_TILE(board, x, y).color == color)
+		return;
+	ZOO_TILE(board, x, y).color = color;
+	ZOO_BOARD_MARK_DIRTY(board);
+}
+
+static ZOO_INLINE void zoo_board_set_tile(zoo_board *board, int16_t x, int16_t y, zoo_tile tile) {
+	if (ZOO_TILE(board, x, y).element == tile.element && ZOO_TILE(board, x, y).color == tile.color)
+		return;
+#ifdef ZOO_USE_ELEMENT_INDEX
+	zoo_element_index_update(board, x, y, ZOO_TILE(board, x, y).element, tile.element);
+#endif
+	ZOO_TILE(board, x, y) = tile;
+	ZOO_BOARD_MARK_DIRTY(board);
+}
+
+// zoo_oop.c
+
+uint16_t zoo_oop_name_hash(zoo_state *state, int16_t stat_id);
+
+// Object code is reference counted, so that stats cloned by zoo_stat_add can
+// share it until one of them writes to it (#ZAP, #RESTORE). Stats bound with
+// #BIND share a single reference instead; code with more than one reference
+// is therefore never bound. Code in ROM is not counted.
+typedef struct {
+	int16_t refs;
+#ifdef ZOO_USE_OOP_CACHE
+	struct s_zoo_oop_cache *cache;
+#endif
+	char data[];
+} zoo_stat_code;
+
+#define ZOO_STAT_CODE(d) ((zoo_stat_code *) ((d) - offsetof(zoo_stat_code, data)))
+
+char *zoo_stat_data_ref(char *data);
+void zoo_stat_data_unshare(zoo_state *state, zoo_stat *stat);
+
+static ZOO_INLINE bool zoo_stat_data_shared(char *data) {
+	return data != NULL && !platform_is_rom_ptr(data) && ZOO_STAT_CODE(data)->refs > 1;
+}
+
+// true if the two stats share their object code through #BIND
+static ZOO_INLINE bool zoo_stat_data_bound(const zoo_stat *a, const zoo_stat *b) {
+	return a->data == b->data && !zoo_stat_data_shared(a->data);
+}
 
 // zoo_oop_label_cache.c
 
+size_t zoo_oop_label_cache_bytes(int16_t label_count);
+void zoo_oop_label_cache_index(zoo_stat *stat);
 void zoo_oop_label_cache_build(zoo_state *state, int16_t stat_id);
 int16_t zoo_oop_label_cache_search(zoo_state *state, int16_t stat_id, const char *object_message, bool zapped);
 void zoo_oop_label_cache_zap(zoo_state *state, int16_t stat_id, int16_t label_data_pos, bool zapped, bool recurse, const char *label);
 
+// zoo_oop_cache.c
+
+#ifdef ZOO_USE_OOP_CACHE
+#define ZOO_OOP_CACHE_WORD 1
+#define ZOO_OOP_CACHE_VALUE 2
+#define ZOO_OOP_CACHE_PLAY 3
+
+typedef struct {
+	int16_t pos; // text offset lexing started at, -1 if unused
+	int16_t end; // text offset lexing stopped at
+	int16_t value; // VALUE: oop_value, PLAY: length of sound
+	uint8_t type; // 0 if stale
+	char chr; // oop_char after lexing
+	// WORD: tokens the word was already looked up as
+	const void *token_table[2];
+	uint8_t token[2];
+	char word[21];
+	uint8_t *sound;
+} zoo_oop_cache_entry;
+
+typedef struct s_zoo_oop_cache {
+	uint16_t mask, count;
+	zoo_oop_cache_entry entries[];
+} zoo_oop_cache;
+
+zoo_oop_cache_entry *zoo_oop_cache_find(zoo_stat *stat, int16_t pos, uint8_t type);
+zoo_oop_cache_entry *zoo_oop_cache_add(zoo_state *state, zoo_stat *stat, int16_t pos, uint8_t type);
+size_t zoo_oop_cache_bytes(char *data);
+void zoo_oop_cache_free(zoo_oop_cache *cache);
+
+static ZOO_INLINE bool zoo_oop_cache_token_get(zoo_oop_cache_entry *entry, const void *table, uint8_t *token) {
+	if (entry != NULL) {
+		if (entry->token_table[0] == table) {
+			*token = entry->token[0];
+			return true;
+		} else if (entry->token_table[1] == table) {
+			*token = entry->token[1];
+			return true;
+		}
+	}
+	return false;
+}
+
+static ZOO_INLINE void zoo_oop_cache_token_set(zoo_oop_cache_entry *entry, const void *table, uint8_t token) {
+	if (entry != NULL) {
+		int i = entry->token_table[0] != NULL ? 1 : 0;
+		entry->token_table[i] = table;
+		entry->token[i] = token;
+	}
+}
+#endif
+
+// metrics
+
+#ifdef ZOO_METRICS
+#define ZOO_METRICS_ADD(state, field, n) ((state)->metrics.field += (n))
+// for code which only has the board at hand
+#define ZOO_BOARD_METRICS_MALLOC(board) ((board)->metrics_mallocs++)
+#else
+#define ZOO_METRICS_ADD(state, field, n)
+#define ZOO_BOARD_METRICS_MALLOC(board)
+#endif
+
+// zoo_profile.c
+
+#ifdef ZOO_PROFILE
+void zoo_profile_record(zoo_state *state, zoo_profile *profile, zoo_profile_counter *counters, uint8_t element, int16_t stat_id, uint32_t start);
+
+// Wraps one element function call. The element is taken before the call, as
+// the call may well replace the tile it belongs to.
+#define ZOO_PROFILE_CALL(state, counters, element, stat_id, call) { \
+		zoo_profile *zoo_profile_p = (state)->profile; \
+		if (zoo_profile_p != NULL) { \
+			uint8_t zoo_profile_element = (element); \
+			uint32_t zoo_profile_start = zoo_profile_p->func_time(); \
+			call; \
+			zoo_profile_record(state, zoo_profile_p, zoo_profile_p->counters, zoo_profile_element, stat_id, zoo_profile_start); \
+		} else { \
+			call; \
+		} \
+	}
+#define ZOO_PROFILE_OOP(state, token) if ((state)->profile != NULL) (state)->profile->oop_commands[token]++
+const char *zoo_oop_token_name(uint8_t token); // zoo_oop.c
+#else
+#define ZOO_PROFILE_CALL(state, counters, element, stat_id, call) { call; }
+#define ZOO_PROFILE_OOP(state, token)
+#endif
+
 // zoo_window.c
 
 void zoo_window_sort(zoo_state *state, zoo_text_window *window);
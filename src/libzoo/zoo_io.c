@@ -24,59 +24,51 @@
 #include <string.h>
 #include "zoo_internal.h"
 
+// memory handles: p and len describe the whole buffer, buf_pos is the
+// current position; the buffer window spans the rest of it (for writes,
+// in MODE_WRITE only)
+
+#define zoo_io_mem_left(h) ((size_t) (((uint8_t *) (h)->p + (h)->len) - (h)->buf_pos))
+
 static uint8_t zoo_io_mem_getc(zoo_io_handle *h) {
-	uint8_t **ptr = (uint8_t **) &h->p;
-	if (h->len <= 0) return 0;
-	h->len--;
-	return *((*ptr)++);
+	if (h->buf_pos >= h->buf_read_end) return 0;
+	return *(h->buf_pos++);
 }
 
 static size_t zoo_io_mem_putc(zoo_io_handle *h, uint8_t v) {
-	uint8_t **ptr = (uint8_t **) &h->p;
-	if (h->len <= 0) return 0;
-	h->len--;
-	*((*ptr)++) = v;
+	if (h->buf_pos >= h->buf_write_end) return 0;
+	*(h->buf_pos++) = v;
 	return 1;
 }
 
 static size_t zoo_io_mem_read(zoo_io_handle *h, uint8_t *d_ptr, size_t len) {
-	uint8_t **ptr = (uint8_t **) &h->p;
-	if (len > h->len) len = h->len;
+	if (len > zoo_io_mem_left(h)) len = zoo_io_mem_left(h);
 	if (len <= 0) return 0;
-	h->len -= len;
-	memcpy(d_ptr, *ptr, len);
-	*ptr += len;
+	memcpy(d_ptr, h->buf_pos, len);
+	h->buf_pos += len;
 	return len;
 }
 
 static size_t zoo_io_mem_write(zoo_io_handle *h, const uint8_t *d_ptr, size_t len) {
-	uint8_t **ptr = (uint8_t **) &h->p;
-	if (len > h->len) len = h->len;
+	if (len > zoo_io_mem_left(h)) len = zoo_io_mem_left(h);
 	if (len <= 0) return 0;
-	h->len -= len;
-	memcpy(*ptr, d_ptr, len);
-	*ptr += len;
+	memcpy(h->buf_pos, d_ptr, len);
+	h->buf_pos += len;
 	return len;
 }
 
-static size_t zoo_io_mem_putc_ro(zoo_io_handle *h, uint8_t v) {
-	return 0;
-}
-
 static size_t zoo_io_mem_write_ro(zoo_io_handle *h, const uint8_t *d_ptr, size_t len) {
 	return 0;
 }
 
 static size_t zoo_io_mem_skip(zoo_io_handle *h, size_t len) {
-	uint8_t **ptr = (uint8_t **) &h->p;
-	if (len > h->len) len = h->len;
-	h->len -= len;
-	*ptr += len;
+	if (len > zoo_io_mem_left(h)) len = zoo_io_mem_left(h);
+	h->buf_pos += len;
 	return len;
 }
 
 static size_t zoo_io_mem_tell(zoo_io_handle *h) {
-	return h->len_orig - h->len;
+	return h->buf_pos - (uint8_t *) h->p;
 }
 
 static void zoo_io_mem_close(zoo_io_handle *h) {
@@ -84,21 +76,24 @@ static void zoo_io_mem_close(zoo_io_handle *h) {
 }
 
 static uint8_t *zoo_io_mem_getptr(zoo_io_handle *h) {
-	return h->p;
+	return h->buf_pos;
 }
 
 zoo_io_handle zoo_io_open_file_mem(uint8_t *ptr, size_t len, zoo_io_mode mode) {
 	zoo_io_handle h;
 	h.p = ptr;
 	h.len = len;
-	h.len_orig = len;
+	h.buf_pos = ptr;
+	h.buf_read_end = ptr + len;
+	h.buf_write_end = (mode == MODE_WRITE) ? (ptr + len) : ptr;
 	h.func_getptr = zoo_io_mem_getptr;
 	h.func_getc = zoo_io_mem_getc;
-	h.func_putc = (mode == MODE_WRITE) ? zoo_io_mem_putc : zoo_io_mem_putc_ro;
+	h.func_putc = zoo_io_mem_putc;
 	h.func_read = zoo_io_mem_read;
 	h.func_write = (mode == MODE_WRITE) ? zoo_io_mem_write : zoo_io_mem_write_ro;
 	h.func_skip = zoo_io_mem_skip;
 	h.func_tell = zoo_io_mem_tell;
 	h.func_close = zoo_io_mem_close;
+	h.func_retain = NULL;
 	return h;
-}
\ No newline at end of file
+}
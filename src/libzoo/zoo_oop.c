@@ -33,9 +33,48 @@
 
 #define oop_word_cmp(c) strncmp(state->oop_word, (c), sizeof(state->oop_word) - 1)
 
+char *zoo_stat_data_alloc(int16_t len) {
+	zoo_stat_code *code = malloc(sizeof(zoo_stat_code) + len);
+	if (code == NULL)
+		return NULL;
+	code->refs = 1;
+#ifdef ZOO_USE_OOP_CACHE
+	code->cache = NULL;
+#endif
+	return code->data;
+}
+
+char *zoo_stat_data_ref(char *data) {
+	ZOO_STAT_CODE(data)->refs++;
+	return data;
+}
+
+// Gives a stat its own copy of shared object code, before writing to it.
+void zoo_stat_data_unshare(zoo_state *state, zoo_stat *stat) {
+	char *data;
+
+	if (!zoo_stat_data_shared(stat->data))
+		return;
+
+	data = zoo_stat_data_alloc(stat->data_len);
+	ZOO_METRICS_ADD(state, mallocs, 1);
+	// out of memory: the write lands in the shared copy, as it used to
+	if (data == NULL)
+		return;
+	memcpy(data, stat->data, stat->data_len);
+	ZOO_STAT_CODE(stat->data)->refs--;
+	stat->data = data;
+}
+
 void zoo_stat_free(zoo_stat *stat) {
-	if (!platform_is_rom_ptr(stat->data))
-		free(stat->data);
+	if (stat->data != NULL && !platform_is_rom_ptr(stat->data)) {
+		if (--ZOO_STAT_CODE(stat->data)->refs <= 0) {
+#ifdef ZOO_USE_OOP_CACHE
+			zoo_oop_cache_free(ZOO_STAT_CODE(stat->data)->cache);
+#endif
+			free(ZOO_STAT_CODE(stat->data));
+		}
+	}
 
 #ifdef ZOO_USE_LABEL_CACHE
 	if (stat->label_cache_size > 0) {
@@ -83,6 +122,18 @@ static ZOO_INLINE void zoo_oop_read_char(zoo_state *state, int16_t stat_id, int1
 GBA_FAST_CODE
 static void zoo_oop_read_word(zoo_state *state, int16_t stat_id, int16_t *position) {
 	int word_pos = 0;
+#ifdef ZOO_USE_OOP_CACHE
+	int16_t start_pos = *position;
+	zoo_oop_cache_entry *entry = zoo_oop_cache_find(&state->board.stats[stat_id], start_pos, ZOO_OOP_CACHE_WORD);
+
+	state->oop_word_entry = entry;
+	if (entry != NULL) {
+		memcpy(state->oop_word, entry->word, sizeof(state->oop_word));
+		state->oop_char = entry->chr;
+		*position = entry->end;
+		return;
+	}
+#endif
 
 	do {
 		zoo_oop_read_char(state, stat_id, position);
@@ -108,11 +159,34 @@ static void zoo_oop_read_word(zoo_state *state, int16_t stat_id, int16_t *positi
 		}
 	}
 	state->oop_word[word_pos] = 0;
+
+#ifdef ZOO_USE_OOP_CACHE
+	if (word_pos < sizeof(state->oop_word)) {
+		entry = zoo_oop_cache_add(state, &state->board.stats[stat_id], start_pos, ZOO_OOP_CACHE_WORD);
+		if (entry != NULL) {
+			memcpy(entry->word, state->oop_word, sizeof(state->oop_word));
+			entry->chr = state->oop_char;
+			entry->end = *position;
+			state->oop_word_entry = entry;
+		}
+	}
+#endif
 }
 
 static void zoo_oop_read_value(zoo_state *state, int16_t stat_id, int16_t *position) {
 	char word[21];
 	int word_pos = 0;
+#ifdef ZOO_USE_OOP_CACHE
+	int16_t start_pos = *position;
+	zoo_oop_cache_entry *entry = zoo_oop_cache_find(&state->board.stats[stat_id], start_pos, ZOO_OOP_CACHE_VALUE);
+
+	if (entry != NULL) {
+		state->oop_value = entry->value;
+		state->oop_char = entry->chr;
+		*position = entry->end;
+		return;
+	}
+#endif
 
 	do {
 		zoo_oop_read_char(state, stat_id, position);
@@ -130,9 +204,105 @@ static void zoo_oop_read_value(zoo_state *state, int16_t stat_id, int16_t *posit
 	}
 
 	state->oop_value = (word_pos > 0) ? atoi(word) : -1;
+
+#ifdef ZOO_USE_OOP_CACHE
+	if (word_pos < sizeof(word)) {
+		entry = zoo_oop_cache_add(state, &state->board.stats[stat_id], start_pos, ZOO_OOP_CACHE_VALUE);
+		if (entry != NULL) {
+			entry->value = state->oop_value;
+			entry->chr = state->oop_char;
+			entry->end = *position;
+		}
+	}
+#endif
+}
+
+#ifdef ZOO_PROFILE
+// Returns the name of an instruction token, for profile output.
+const char *zoo_oop_token_name(uint8_t token) {
+	int i;
+
+	for (i = 0; i <= tok_zoo_oop_token_ins.mask; i++) {
+		if (tok_zoo_oop_token_ins.entries[i].id == token)
+			return tok_zoo_oop_token_ins.entries[i].word;
+	}
+	return "";
 }
+#endif
 
+// Looks up state->oop_word in a token table.
+GBA_FAST_CODE
+static uint8_t zoo_oop_word_token(zoo_state *state, const tok_table_zoo_oop_token *table) {
+	uint8_t token;
+
+#ifdef ZOO_USE_OOP_CACHE
+	if (zoo_oop_cache_token_get(state->oop_word_entry, table, &token))
+		return token;
+#endif
+	token = zoo_oop_token_search(table, state->oop_word);
+#ifdef ZOO_USE_OOP_CACHE
+	zoo_oop_cache_token_set(state->oop_word_entry, table, token);
+#endif
+	return token;
+}
+
+// Looks up state->oop_word among element names; returns 255 if none match.
+GBA_FAST_CODE
+static uint8_t zoo_oop_word_element(zoo_state *state) {
+	uint8_t element;
+
+#ifdef ZOO_USE_OOP_CACHE
+	if (zoo_oop_cache_token_get(state->oop_word_entry, zoo_element_defs, &element))
+		return element;
+#endif
+	for (element = 0; element <= ZOO_MAX_ELEMENT; element++) {
+		// zoo_oop_strip_chars(name, zoo_element_defs[i].name, sizeof(name) - 1);
+		// if (!strncmp(name, state->oop_word, 20)) {
+		if (!strncmp(zoo_element_defs[element].oop_strip_name, state->oop_word, 20))
+			break;
+	}
+	if (element > ZOO_MAX_ELEMENT)
+		element = 255;
+#ifdef ZOO_USE_OOP_CACHE
+	zoo_oop_cache_token_set(state->oop_word_entry, zoo_element_defs, element);
+#endif
+	return element;
+}
+
+// true if object code from this position on can be read straight from
+// stat->data, rather than through zoo_oop_read_char
+static ZOO_INLINE bool zoo_oop_data_direct(zoo_stat *stat, int16_t position) {
+#ifdef ZOO_NO_OBJECT_CODE_WRITES
+	if (position <= 1 && stat->label_cache_chr2 != 0)
+		return false;
+#endif
+	return position >= 0 && position < stat->data_len;
+}
+
+GBA_FAST_CODE
 static void zoo_oop_skip_line(zoo_state *state, int16_t stat_id, int16_t *position) {
+	zoo_stat *stat = &(state->board.stats[stat_id]);
+	const char *line, *end, *nul;
+	int16_t len;
+
+	if (zoo_oop_data_direct(stat, *position)) {
+		line = stat->data + *position;
+		len = stat->data_len - *position;
+		end = memchr(line, '\r', len);
+		nul = memchr(line, '\0', end != NULL ? (end - line) : len);
+		if (nul != NULL)
+			end = nul;
+
+		if (end != NULL) {
+			*position = end - stat->data + 1;
+			state->oop_char = *end;
+		} else {
+			*position = stat->data_len;
+			state->oop_char = 0;
+		}
+		return;
+	}
+
 	do {
 		zoo_oop_read_char(state, stat_id, position);
 	} while (state->oop_char != '\0' && state->oop_char != '\r');
@@ -141,7 +311,7 @@ static void zoo_oop_skip_line(zoo_state *state, int16_t stat_id, int16_t *positi
 static bool zoo_oop_parse_direction(zoo_state *state, int16_t stat_id, int16_t *position, int16_t *dx, int16_t *dy) {
 	bool result = true;
 
-	switch (zoo_oop_token_search(tok_zoo_oop_token_dir, state->oop_word)) {
+	switch (zoo_oop_word_token(state, &tok_zoo_oop_token_dir)) {
 	case TOK_DIR_NORTH: {
 		*dx = 0;
 		*dy = -1;
@@ -224,13 +394,28 @@ static void zoo_oop_read_direction(zoo_state *state, int16_t stat_id, int16_t *p
 
 GBA_FAST_CODE
 int16_t zoo_oop_find_string_from(zoo_state *state, int16_t stat_id, const char *str, int16_t start_pos, int16_t end_pos) {
-	int16_t pos, word_pos, cmp_pos;
-	int16_t data_len = end_pos >= 0 ? (end_pos+1) : state->board.stats[stat_id].data_len;
-	const char *ptr_str;
+	zoo_stat *stat = &(state->board.stats[stat_id]);
+	int16_t pos, word_pos, cmp_pos, scan_len;
+	int16_t data_len = end_pos >= 0 ? (end_pos+1) : stat->data_len;
+	const char *ptr_str, *next;
+	// a first character with no other case can be skipped to with memchr
+	bool scan = str[0] != '\0' && zoo_toupper(str[0]) == str[0] && !(str[0] >= 'A' && str[0] <= 'Z');
 
 	pos = start_pos;
 
 	while (pos < data_len) {
+		if (scan && zoo_oop_data_direct(stat, pos)) {
+			scan_len = (data_len < stat->data_len ? data_len : stat->data_len) - pos;
+			next = memchr(stat->data + pos, str[0], scan_len);
+			if (next == NULL) {
+				// leave oop_char as comparing at every position would have
+				pos = data_len - 1;
+				state->oop_char = pos < stat->data_len ? stat->data[pos] : 0;
+				break;
+			}
+			pos = next - stat->data;
+		}
+
 		cmp_pos = pos;
 		ptr_str = str;
 
@@ -264,6 +449,100 @@ static ZOO_INLINE int16_t zoo_oop_find_string(zoo_state *state, int16_t stat_id,
 	return zoo_oop_find_string_from(state, stat_id, str, 0, -1);
 }
 
+// Reads a stat's @name as zoo_oop_read_word would, keeping the first 20
+// characters (all that zoo_oop_iterate_stat compares). Returns false if the
+// stat has no name line.
+static bool zoo_oop_read_name(zoo_state *state, int16_t stat_id, char *name) {
+	int16_t pos = 0;
+	int name_pos = 0;
+
+	if (state->board.stats[stat_id].data == NULL)
+		return false;
+
+	zoo_oop_read_char(state, stat_id, &pos);
+	if (state->oop_char != '@')
+		return false;
+
+	do {
+		zoo_oop_read_char(state, stat_id, &pos);
+	} while (state->oop_char == ' ');
+
+	state->oop_char = zoo_toupper(state->oop_char);
+	if (state->oop_char < '0' || state->oop_char > '9') {
+		while (
+			(state->oop_char >= 'A' && state->oop_char <= 'Z')
+			|| (state->oop_char == ':')
+			|| (state->oop_char >= '0' && state->oop_char <= '9')
+			|| (state->oop_char == '_')
+		) {
+			if (name_pos < 20)
+				name[name_pos++] = state->oop_char;
+
+			zoo_oop_read_char(state, stat_id, &pos);
+			state->oop_char = zoo_toupper(state->oop_char);
+		}
+	}
+	name[name_pos] = 0;
+	return true;
+}
+
+static uint16_t zoo_oop_name_hash_str(const char *name) {
+	uint16_t hash = 5381;
+	int i;
+
+	for (i = 0; i < 20 && name[i] != 0; i++)
+		hash = (hash << 5) + hash + (uint8_t) name[i];
+	return hash != 0 ? hash : 1;
+}
+
+uint16_t zoo_oop_name_hash(zoo_state *state, int16_t stat_id) {
+	char name[21];
+
+	if (!zoo_oop_read_name(state, stat_id, name))
+		return 0;
+	return zoo_oop_name_hash_str(name);
+}
+
+// Returns the first stat from start_id on with the given name, or
+// stat_count + 1 if there is none.
+GBA_FAST_CODE
+static int16_t zoo_oop_name_index_next(zoo_state *state, int16_t start_id, const char *lookup) {
+	zoo_board *board = &state->board;
+	char name[21];
+	uint16_t hash;
+	int16_t i, bucket;
+
+	if (!board->name_hash_valid) {
+		for (i = 1; i <= board->stat_count; i++)
+			board->name_hash[i] = zoo_oop_name_hash(state, i);
+		board->name_hash_valid = true;
+		board->name_chain_valid = false;
+	}
+
+	if (!board->name_chain_valid) {
+		for (i = 0; i < ZOO_NAME_INDEX_BUCKETS; i++)
+			board->name_head[i] = -1;
+		// walk backwards, so that the chains end up in ascending order
+		for (i = board->stat_count; i >= 1; i--) {
+			if (board->name_hash[i] != 0) {
+				bucket = board->name_hash[i] & (ZOO_NAME_INDEX_BUCKETS - 1);
+				board->name_next[i] = board->name_head[bucket];
+				board->name_head[bucket] = i;
+			}
+		}
+		board->name_chain_valid = true;
+	}
+
+	hash = zoo_oop_name_hash_str(lookup);
+	for (i = board->name_head[hash & (ZOO_NAME_INDEX_BUCKETS - 1)]; i >= 0; i = board->name_next[i]) {
+		if (i >= start_id && board->name_hash[i] == hash
+			&& zoo_oop_read_name(state, i, name) && !strncmp(name, lookup, 20))
+			return i;
+	}
+
+	return board->stat_count + 1;
+}
+
 GBA_FAST_CODE
 static bool zoo_oop_iterate_stat(zoo_state *state, int16_t stat_id, int16_t *i_stat, const char *lookup) {
 	int16_t pos;
@@ -288,21 +567,8 @@ static bool zoo_oop_iterate_stat(zoo_state *state, int16_t stat_id, int16_t *i_s
 			found = true;
 		}
 	} else {
-		while (*i_stat <= state->board.stat_count) {
-			if (state->board.stats[*i_stat].data != NULL) {
-				pos = 0;
-				zoo_oop_read_char(state, *i_stat, &pos);
-				if (state->oop_char == '@') {
-					zoo_oop_read_word(state, *i_stat, &pos);
-					if (!oop_word_cmp(lookup)) {
-						found = true;
-					}
-				}
-			}
-
-			if (found) break;
-			*i_stat += 1;
-		}
+		*i_stat = zoo_oop_name_index_next(state, *i_stat, lookup);
+		found = *i_stat <= state->board.stat_count;
 	}
 
 	return found;
@@ -421,7 +687,7 @@ static bool zoo_oop_parse_tile(zoo_state *state, int16_t stat_id, int16_t *posit
 	tile->color = 0x00;
 
 	zoo_oop_read_word(state, stat_id, position);
-	i = zoo_oop_token_search(tok_zoo_oop_token_color, state->oop_word);
+	i = zoo_oop_word_token(state, &tok_zoo_oop_token_color);
 	if (i != TOK_COLOR_INVALID) {
 		tile->color = i + 9;
 		zoo_oop_read_word(state, stat_id, position);			
@@ -438,13 +704,10 @@ static bool zoo_oop_parse_tile(zoo_state *state, int16_t stat_id, int16_t *posit
 	}
 	*/
 
-	for (i = 0; i <= ZOO_MAX_ELEMENT; i++) {
-		// zoo_oop_strip_chars(name, zoo_element_defs[i].name, sizeof(name) - 1);
-		// if (!strncmp(name, state->oop_word, 20)) {
-		if (!strncmp(zoo_element_defs[i].oop_strip_name, state->oop_word, 20)) {
-			tile->element = i;
-			return true;
-		}
+	i = zoo_oop_word_element(state);
+	if (i != 255) {
+		tile->element = i;
+		return true;
 	}
 
 	return false;
@@ -466,6 +729,19 @@ static bool zoo_find_tile_on_board(zoo_state *state, int16_t *x, int16_t *y, zoo
 	int16_t lx = *x;
 	int16_t ly = *y;
 
+#ifdef ZOO_USE_ELEMENT_INDEX
+	while (zoo_element_index_next(&state->board, tile.element, &lx, &ly)) {
+		if ((tile.color == 0) || (zoo_get_color_for_tile_match(state, ZOO_TILE(&state->board, lx, ly)) == tile.color)) {
+			*x = lx;
+			*y = ly;
+			return true;
+		}
+	}
+
+	*x = 1;
+	*y = ZOO_BOARD_HEIGHT + 1;
+	return false;
+#else
 	while (true) {
 		lx += 1;
 		if (lx > ZOO_BOARD_WIDTH) {
@@ -478,20 +754,21 @@ static bool zoo_find_tile_on_board(zoo_state *state, int16_t *x, int16_t *y, zoo
 			}
 		}
 
-		if (state->board.tiles[lx][ly].element == tile.element) {
-			if ((tile.color == 0) || (zoo_get_color_for_tile_match(state, state->board.tiles[lx][ly]) == tile.color)) {
+		if (ZOO_TILE(&state->board, lx, ly).element == tile.element) {
+			if ((tile.color == 0) || (zoo_get_color_for_tile_match(state, ZOO_TILE(&state->board, lx, ly)) == tile.color)) {
 				*x = lx;
 				*y = ly;
 				return true;
 			}
 		}
 	}
+#endif
 }
 
 static void zoo_oop_place_tile(zoo_state *state, int16_t x, int16_t y, zoo_tile tile) {
 	uint8_t color;
 
-	if (state->board.tiles[x][y].element == ZOO_E_PLAYER) {
+	if (ZOO_TILE(&state->board, x, y).element == ZOO_E_PLAYER) {
 		return;
 	}
 
@@ -499,22 +776,22 @@ static void zoo_oop_place_tile(zoo_state *state, int16_t x, int16_t y, zoo_tile
 	if (zoo_element_defs[tile.element].color < ZOO_COLOR_SPECIAL_MIN) {
 		color = zoo_element_defs[tile.element].color;
 	} else {
-		if (color == 0) color = state->board.tiles[x][y].color;
+		if (color == 0) color = ZOO_TILE(&state->board, x, y).color;
 		if (color == 0) color = 0x0F;
 		if (zoo_element_defs[tile.element].color == ZOO_COLOR_WHITE_ON_CHOICE) {
 			color = ((color - 8) << 4) | 0x0F;
 		}
 	}
 
-	if (state->board.tiles[x][y].element == tile.element) {
-		state->board.tiles[x][y].color = color;
+	if (ZOO_TILE(&state->board, x, y).element == tile.element) {
+		zoo_board_set_color(&state->board, x, y, color);
 	} else {
 		zoo_board_damage_tile(state, x, y);
 		if (zoo_element_defs[tile.element].cycle >= 0) {
 			zoo_stat_add(state, x, y, tile.element, color, zoo_element_defs[tile.element].cycle, &zoo_stat_template_default);
 		} else {
-			state->board.tiles[x][y].element = tile.element;
-			state->board.tiles[x][y].color = color;
+			zoo_board_set_element(&state->board, x, y, tile.element);
+			zoo_board_set_color(&state->board, x, y, color);
 		}
 	}
 
@@ -527,7 +804,7 @@ static bool zoo_oop_check_condition(zoo_state *state, int16_t stat_id, int16_t *
 	// otherwise a zoo_oop_error in "ANY" could lead to invalid data
 	zoo_tile tile = {0, 0};
 
-	switch (zoo_oop_token_search(tok_zoo_oop_token_cond, state->oop_word)) {
+	switch (zoo_oop_word_token(state, &tok_zoo_oop_token_cond)) {
 	case TOK_COND_NOT:
 		zoo_oop_read_word(state, stat_id, position);
 		return !zoo_oop_check_condition(state, stat_id, position);
@@ -539,9 +816,9 @@ static bool zoo_oop_check_condition(zoo_state *state, int16_t stat_id, int16_t *
 			state->board.stats[stat_id].y - state->board.stats[0].y) == 1;
 	case TOK_COND_BLOCKED:
 		zoo_oop_read_direction(state, stat_id, position, &ix, &iy);
-		return !zoo_element_defs[state->board.tiles
-			[state->board.stats[stat_id].x + ix]
-			[state->board.stats[stat_id].y + iy]
+		return !zoo_element_defs[ZOO_TILE(&state->board,
+			state->board.stats[stat_id].x + ix,
+			state->board.stats[stat_id].y + iy)
 		.element].walkable;
 	case TOK_COND_ENERGIZED:
 		return state->world.info.energizer_ticks > 0;
@@ -631,7 +908,11 @@ void zoo_oop_execute(zoo_state *state, int16_t stat_id, int16_t *position, const
 	bool counter_subtract;
 	int16_t bind_stat_id;
 	int16_t ins_count;
+	uint8_t ins;
 	zoo_tile arg_tile, arg_tile2;
+#ifdef ZOO_USE_OOP_CACHE
+	zoo_oop_cache_entry *play_entry;
+#endif
 	//
 	zoo_text_window text_window;
 
@@ -691,11 +972,11 @@ ReadInstruction:
 			zoo_oop_read_word(state, stat_id, position);
 			if (zoo_oop_parse_direction(state, stat_id, position, &dx, &dy)) {
 				if (dx != 0 || dy != 0) {
-					if (!zoo_element_defs[state->board.tiles[stat->x + dx][stat->y + dy].element].walkable) {
+					if (!zoo_element_defs[ZOO_TILE(&state->board, stat->x + dx, stat->y + dy).element].walkable) {
 						zoo_element_push(state, stat->x + dx, stat->y + dy, dx, dy);
 					}
 
-					if (zoo_element_defs[state->board.tiles[stat->x + dx][stat->y + dy].element].walkable) {
+					if (zoo_element_defs[ZOO_TILE(&state->board, stat->x + dx, stat->y + dy).element].walkable) {
 						zoo_stat_move(state, stat_id, stat->x + dx, stat->y + dy);
 						repeat_ins_next_tick = false;
 					}
@@ -722,15 +1003,19 @@ ReadCommand:
 				goto ReadInstruction;
 			} else {
 				ins_count++;
-				switch (zoo_oop_token_search(tok_zoo_oop_token_ins, state->oop_word)) {
+				state->oop_frame_ins++;
+				ZOO_METRICS_ADD(state, oop_instructions, 1);
+				ins = zoo_oop_word_token(state, &tok_zoo_oop_token_ins);
+				ZOO_PROFILE_OOP(state, ins);
+				switch (ins) {
 				case TOK_INS_GO: {
 					zoo_oop_read_direction(state, stat_id, position, &dx, &dy);
 
-					if (!zoo_element_defs[state->board.tiles[stat->x + dx][stat->y + dy].element].walkable) {
+					if (!zoo_element_defs[ZOO_TILE(&state->board, stat->x + dx, stat->y + dy).element].walkable) {
 						zoo_element_push(state, stat->x + dx, stat->y + dy, dx, dy);
 					}
 
-					if (zoo_element_defs[state->board.tiles[stat->x + dx][stat->y + dy].element].walkable) {
+					if (zoo_element_defs[ZOO_TILE(&state->board, stat->x + dx, stat->y + dy).element].walkable) {
 						zoo_stat_move(state, stat_id, stat->x + dx, stat->y + dy);
 					} else {
 						repeat_ins_next_tick = true;
@@ -741,11 +1026,11 @@ ReadCommand:
                 case TOK_INS_TRY: {
 					zoo_oop_read_direction(state, stat_id, position, &dx, &dy);
 
-					if (!zoo_element_defs[state->board.tiles[stat->x + dx][stat->y + dy].element].walkable) {
+					if (!zoo_element_defs[ZOO_TILE(&state->board, stat->x + dx, stat->y + dy).element].walkable) {
 						zoo_element_push(state, stat->x + dx, stat->y + dy, dx, dy);
 					}
 
-					if (zoo_element_defs[state->board.tiles[stat->x + dx][stat->y + dy].element].walkable) {
+					if (zoo_element_defs[ZOO_TILE(&state->board, stat->x + dx, stat->y + dy).element].walkable) {
 						zoo_stat_move(state, stat_id, stat->x + dx, stat->y + dy);
 						stop_running = true;
 					} else {
@@ -792,7 +1077,7 @@ ReadCommand:
 
 					zoo_oop_read_word(state, stat_id, position);
 		
-					switch (zoo_oop_token_search(tok_zoo_oop_token_give, state->oop_word)) {
+					switch (zoo_oop_word_token(state, &tok_zoo_oop_token_give)) {
 					case TOK_GIVE_HEALTH: {
 						counter_ptr = &(state->world.info.health);
 					} break;
@@ -855,9 +1140,14 @@ ReadCommand:
 						zoo_oop_find_label(state, stat_id, buf2,
 						&label_stat_id, &label_data_pos, "\r:")
 					) {
+						ZOO_BOARD_MARK_DIRTY(&state->board);
+						// a label at the very start can be part of the name line
+						if (label_data_pos == 0)
+							state->board.name_hash_valid = false;
 #ifdef ZOO_USE_LABEL_CACHE
 						zoo_oop_label_cache_zap(state, label_stat_id, label_data_pos, true, false, buf2);
 #else
+						zoo_stat_data_unshare(state, &state->board.stats[label_stat_id]);
 						state->board.stats[label_stat_id].data[label_data_pos + 1] = '\'';
 #endif
 					}
@@ -875,9 +1165,14 @@ ReadCommand:
 						zoo_oop_find_label(state, stat_id, buf2,
 						&label_stat_id, &label_data_pos, "\r'")
 					) {
+						ZOO_BOARD_MARK_DIRTY(&state->board);
+						// a label at the very start can be part of the name line
+						if (label_data_pos == 0)
+							state->board.name_hash_valid = false;
 #ifdef ZOO_USE_LABEL_CACHE
 						zoo_oop_label_cache_zap(state, label_stat_id, label_data_pos, false, true, buf + 2);
 #else
+						zoo_stat_data_unshare(state, &state->board.stats[label_stat_id]);
 						do {
 							state->board.stats[label_stat_id].data[label_data_pos + 1] = ':';
 							// libzoo fix: optimization - no need to check already checked parts of the code
@@ -922,7 +1217,7 @@ ReadCommand:
 						&& ((stat->y + dy) > 0)
 						&& ((stat->y + dy) < ZOO_BOARD_HEIGHT)
 					) {
-						if (!zoo_element_defs[state->board.tiles[stat->x + dx][stat->y + dy]
+						if (!zoo_element_defs[ZOO_TILE(&state->board, stat->x + dx, stat->y + dy)
 							.element].walkable
 						) {
 							zoo_element_push(state, stat->x + dx, stat->y + dy, dx, dy);
@@ -950,8 +1245,36 @@ ReadCommand:
 					}
 				} break;
                 case TOK_INS_PLAY: {
+#ifdef ZOO_USE_OOP_CACHE
+					play_entry = zoo_oop_cache_find(stat, *position, ZOO_OOP_CACHE_PLAY);
+					if (play_entry != NULL) {
+						*position = play_entry->end;
+						state->oop_char = play_entry->chr;
+						if (play_entry->value > 0) {
+							zoo_sound_queue(&(state->sound), -1, play_entry->sound, play_entry->value);
+						}
+						line_finished = false;
+						break;
+					}
+					play_entry = zoo_oop_cache_add(state, stat, *position, ZOO_OOP_CACHE_PLAY);
+#endif
 					zoo_oop_read_line_to_end(state, stat_id, position, buf, sizeof(buf) - 1);
 					buf2_len = zoo_sound_parse(buf, (uint8_t*) buf2, sizeof(buf2));
+#ifdef ZOO_USE_OOP_CACHE
+					if (play_entry != NULL) {
+						play_entry->end = *position;
+						play_entry->chr = state->oop_char;
+						play_entry->value = buf2_len;
+						if (buf2_len > 0) {
+							play_entry->sound = malloc(buf2_len);
+							ZOO_METRICS_ADD(state, mallocs, 1);
+							if (play_entry->sound != NULL)
+								memcpy(play_entry->sound, buf2, buf2_len);
+							else
+								play_entry->type = 0;
+						}
+					}
+#endif
 					if (buf2_len > 0) {
 						zoo_sound_queue(&(state->sound), -1, (uint8_t*) buf2, buf2_len);
 					}
@@ -960,7 +1283,7 @@ ReadCommand:
                 case TOK_INS_CYCLE: {
 					zoo_oop_read_value(state, stat_id, position);
 					if (state->oop_value > 0) {
-						stat->cycle = state->oop_value;
+						zoo_stat_set_cycle(state, stat_id, state->oop_value);
 					}
 				} break;
                 case TOK_INS_CHAR: {
@@ -984,16 +1307,23 @@ ReadCommand:
 						// libzoo fix: add Bind_StatDataInUse check
 						for (ix = 1; ix <= state->board.stat_count; ix++) {
 							if (ix == stat_id) continue;
-							if (state->board.stats[ix].data == stat->data) goto Bind_StatDataInUse;
+							if (zoo_stat_data_bound(&state->board.stats[ix], stat)) goto Bind_StatDataInUse;
 						}
 						zoo_stat_free(stat);
 					Bind_StatDataInUse:
+						// bound stats share one reference, so the target
+						// can't stay a copy-on-write clone
+						zoo_stat_data_unshare(state, &state->board.stats[bind_stat_id]);
 						stat->data = state->board.stats[bind_stat_id].data;
 						stat->data_len = state->board.stats[bind_stat_id].data_len;
 #ifdef ZOO_USE_LABEL_CACHE
 						stat->label_cache = state->board.stats[bind_stat_id].label_cache;
 						stat->label_cache_size = state->board.stats[bind_stat_id].label_cache_size;
 #endif
+						if (state->board.name_hash_valid) {
+							state->board.name_hash[stat_id] = zoo_oop_name_hash(state, stat_id);
+							state->board.name_chain_valid = false;
+						}
 						*position = 0;
 					}
 				} break;
@@ -1029,7 +1359,13 @@ ReadCommand:
 			zoo_window_append(&text_window, buf);
 		} break;
 		}
-	} while (!end_of_program && !stop_running && !repeat_ins_next_tick && !replace_stat && ins_count <= 32);
+	} while (!end_of_program && !stop_running && !repeat_ins_next_tick && !replace_stat && ins_count <= state->oop_ins_limit);
+
+	if (ins_count > state->oop_ins_limit) {
+		if (stat->oop_limit_hits < 0xFFFF)
+			stat->oop_limit_hits++;
+		state->oop_limit_hits++;
+	}
 
 	if (repeat_ins_next_tick) {
 		*position = last_position;
@@ -1039,6 +1375,11 @@ ReadCommand:
 		*position = -1;
 	}
 
+	if (text_window.line_count > 0) {
+		// one per line, plus the array holding them
+		ZOO_METRICS_ADD(state, mallocs, text_window.line_count + 1);
+	}
+
 	if (text_window.line_count > 1) {
 		name_position = 0;
 		zoo_oop_read_char(state, stat_id, &name_position);
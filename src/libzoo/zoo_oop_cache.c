@@ -0,0 +1,181 @@
+/**
+ * Copyright (c) 2020 Adrian Siekierka
+ *
+ * Based on a reconstruction of code from ZZT,
+ * Copyright 1991 Epic MegaGames, used with permission.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "zoo_internal.h"
+
+/**
+ * Object code cache implementation.
+ * Method: Remember what the lexer made of object code the first time it
+ * read it - words along with the tokens they were looked up as, numbers,
+ * and #PLAY music in its parsed form - keyed by the text offset it started
+ * reading at.
+ *
+ * As the cache is keyed by text offset, it never has to be consulted
+ * anywhere but in the lexer: positions, #SEND jumps and saved games still
+ * refer to the code text itself.
+ *
+ * The only writes to object code are #ZAP and #RESTORE, which change the
+ * first character of a line; the lexers never read past the end of a line,
+ * so nothing lexed from anywhere but the start of a line can depend on
+ * them. Those are never cached.
+ *
+ * The cache belongs to the code, not to the stat, so clones and #BIND
+ * targets share it. Code in ROM is not cached.
+ */
+
+#define ZOO_OOP_CACHE_MIN_SIZE 64
+
+static ZOO_INLINE uint16_t zoo_oop_cache_slot(zoo_oop_cache *cache, int16_t pos) {
+	return ((uint32_t) pos * 0x9E3779B1) >> 16 & cache->mask;
+}
+
+static zoo_oop_cache *zoo_oop_cache_alloc(uint16_t size) {
+	zoo_oop_cache *cache = malloc(sizeof(zoo_oop_cache) + sizeof(zoo_oop_cache_entry) * size);
+	uint16_t i;
+
+	if (cache == NULL)
+		return NULL;
+	cache->mask = size - 1;
+	cache->count = 0;
+	for (i = 0; i < size; i++)
+		cache->entries[i].pos = -1;
+	return cache;
+}
+
+GBA_FAST_CODE
+zoo_oop_cache_entry *zoo_oop_cache_find(zoo_stat *stat, int16_t pos, uint8_t type) {
+	zoo_oop_cache *cache;
+	zoo_oop_cache_entry *entry;
+	uint16_t i;
+
+	if (stat->data == NULL || platform_is_rom_ptr(stat->data))
+		return NULL;
+	cache = ZOO_STAT_CODE(stat->data)->cache;
+	if (cache == NULL)
+		return NULL;
+
+	for (i = zoo_oop_cache_slot(cache, pos); ; i = (i + 1) & cache->mask) {
+		entry = &cache->entries[i];
+		if (entry->pos == pos)
+			return entry->type == type ? entry : NULL;
+		if (entry->pos < 0)
+			return NULL;
+	}
+}
+
+// Doubles the size of a cache once it is half full.
+static zoo_oop_cache *zoo_oop_cache_grow(zoo_oop_cache *cache) {
+	zoo_oop_cache *new_cache;
+	zoo_oop_cache_entry *entry;
+	uint16_t i, j;
+
+	if (cache->mask >= 0x7FFF)
+		return NULL;
+	new_cache = zoo_oop_cache_alloc((cache->mask + 1) * 2);
+	if (new_cache == NULL)
+		return NULL;
+
+	for (i = 0; i <= cache->mask; i++) {
+		entry = &cache->entries[i];
+		if (entry->pos < 0)
+			continue;
+		for (j = zoo_oop_cache_slot(new_cache, entry->pos); new_cache->entries[j].pos >= 0; j = (j + 1) & new_cache->mask);
+		new_cache->entries[j] = *entry;
+		new_cache->count++;
+	}
+
+	free(cache);
+	return new_cache;
+}
+
+// Returns a blank entry for the lexer to fill in, or NULL if the result of
+// lexing from this position can't be cached.
+zoo_oop_cache_entry *zoo_oop_cache_add(zoo_state *state, zoo_stat *stat, int16_t pos, uint8_t type) {
+	zoo_stat_code *code;
+	zoo_oop_cache *cache;
+	zoo_oop_cache_entry *entry;
+	uint16_t i;
+
+	if (stat->data == NULL || platform_is_rom_ptr(stat->data))
+		return NULL;
+	if (pos <= 0 || pos >= stat->data_len || stat->data[pos - 1] == '\r')
+		return NULL;
+
+	code = ZOO_STAT_CODE(stat->data);
+	cache = code->cache;
+	if (cache == NULL) {
+		cache = zoo_oop_cache_alloc(ZOO_OOP_CACHE_MIN_SIZE);
+	} else if ((cache->count + 1) * 2 > cache->mask + 1) {
+		cache = zoo_oop_cache_grow(cache);
+	}
+	if (cache == NULL)
+		return NULL;
+	if (cache != code->cache)
+		ZOO_METRICS_ADD(state, mallocs, 1);
+	code->cache = cache;
+
+	for (i = zoo_oop_cache_slot(cache, pos); ; i = (i + 1) & cache->mask) {
+		entry = &cache->entries[i];
+		if (entry->pos == pos) {
+			// lexed differently before; replace it
+			free(entry->sound);
+			break;
+		}
+		if (entry->pos < 0) {
+			cache->count++;
+			break;
+		}
+	}
+
+	memset(entry, 0, sizeof(zoo_oop_cache_entry));
+	entry->pos = pos;
+	entry->type = type;
+	return entry;
+}
+
+size_t zoo_oop_cache_bytes(char *data) {
+	zoo_oop_cache *cache;
+
+	if (data == NULL || platform_is_rom_ptr(data))
+		return 0;
+	cache = ZOO_STAT_CODE(data)->cache;
+	if (cache == NULL)
+		return 0;
+	return sizeof(zoo_oop_cache) + sizeof(zoo_oop_cache_entry) * (cache->mask + 1);
+}
+
+void zoo_oop_cache_free(zoo_oop_cache *cache) {
+	uint16_t i;
+
+	if (cache == NULL)
+		return;
+	for (i = 0; i <= cache->mask; i++) {
+		if (cache->entries[i].pos >= 0)
+			free(cache->entries[i].sound);
+	}
+	free(cache);
+}
@@ -35,12 +35,116 @@
  * Goals:
  * - improve performance of common commands, like #SEND, #ZAP and #RESTORE
  * - allow blocking writes to object code (on ROM-based platforms)
+ *
+ * Each label also carries the hash and length of its name (the run of
+ * letters and underscores following the colon), and labels with the same
+ * hash are chained in code order. A message made only of such characters
+ * can only match a label with exactly that name, so looking it up takes
+ * one probe and a compare; other messages fall back to a scan.
  */
 
+#define ZOO_LABEL_HASH_INIT 5381
+
+static ZOO_INLINE bool zoo_oop_label_char(char c) {
+	c = zoo_toupper(c);
+	return (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static ZOO_INLINE uint16_t zoo_oop_label_hash_step(uint16_t hash, char c) {
+	return (hash << 5) + hash + zoo_toupper(c);
+}
+
+static int16_t zoo_oop_label_cache_buckets(int16_t label_count) {
+	int16_t buckets = 1;
+	while (buckets < label_count)
+		buckets <<= 1;
+	return buckets;
+}
+
+// The bucket heads follow the labels, in the same allocation.
+static ZOO_INLINE int16_t *zoo_oop_label_cache_heads(zoo_stat *stat) {
+	return (int16_t *) (stat->label_cache + (stat->label_cache_size - 1));
+}
+
+size_t zoo_oop_label_cache_bytes(int16_t label_count) {
+	return sizeof(zoo_stat_label) * label_count + sizeof(int16_t) * zoo_oop_label_cache_buckets(label_count);
+}
+
+// Fills in the name hashes and chains of a label cache, given the position
+// and zap state of each label.
+void zoo_oop_label_cache_index(zoo_stat *stat) {
+	int16_t label_count = stat->label_cache_size - 1;
+	int16_t mask = zoo_oop_label_cache_buckets(label_count) - 1;
+	int16_t *heads = zoo_oop_label_cache_heads(stat);
+	zoo_stat_label *label;
+	int16_t i, pos, len;
+	uint16_t hash;
+
+	for (i = 0; i <= mask; i++)
+		heads[i] = -1;
+
+	// walk backwards, so that the chains end up in code order
+	for (i = label_count - 1; i >= 0; i--) {
+		label = &stat->label_cache[i];
+		hash = ZOO_LABEL_HASH_INIT;
+		len = 0;
+		for (pos = label->pos + 2; pos < stat->data_len && zoo_oop_label_char(stat->data[pos]); pos++, len++)
+			hash = zoo_oop_label_hash_step(hash, stat->data[pos]);
+
+		label->hash = hash;
+		// names longer than an OOP word can't be matched by one anyway
+		label->len = len > 255 ? 255 : len;
+		label->next = heads[hash & mask];
+		heads[hash & mask] = i;
+	}
+}
+
+// Hashes a message, if it is made only of label name characters followed
+// by the given terminator.
+static bool zoo_oop_label_key(const char *str, const char *term, uint16_t *hash, uint8_t *len) {
+	int16_t i;
+
+	*hash = ZOO_LABEL_HASH_INIT;
+	for (i = 0; zoo_oop_label_char(str[i]); i++) {
+		if (i >= 255) return false;
+		*hash = zoo_oop_label_hash_step(*hash, str[i]);
+	}
+	*len = i;
+	return !strcmp(str + i, term);
+}
+
+static bool zoo_oop_label_name_cmp(zoo_stat *stat, zoo_stat_label *label, const char *str, uint16_t hash, uint8_t len) {
+	int16_t i;
+
+	if (label->hash != hash || label->len != len)
+		return false;
+	for (i = 0; i < len; i++) {
+		if (zoo_toupper(stat->data[label->pos + 2 + i]) != zoo_toupper(str[i]))
+			return false;
+	}
+	return true;
+}
+
+// Returns the position of the first label at or after pos, or -1.
+static int16_t zoo_oop_label_cache_next(zoo_stat *stat, int16_t pos) {
+	const char *next;
+
+	while (pos < (stat->data_len-1)) {
+		next = memchr(stat->data + pos, '\r', (stat->data_len-1) - pos);
+		if (next == NULL)
+			break;
+		pos = next - stat->data;
+		if (stat->data[pos+1] == ':' || stat->data[pos+1] == '\'')
+			return pos;
+		pos++;
+	}
+	return -1;
+}
+
 void zoo_oop_label_cache_build(zoo_state *state, int16_t stat_id) {
 	zoo_stat *stat = &state->board.stats[stat_id];
 	int16_t label_count = 0;
-	int16_t pos, label_pos, last_label_pos;
+	int16_t pos, label_pos;
 
 	if (stat->data != NULL && stat->data_len > 0) {
 		if (stat->label_cache_size > 0) {
@@ -49,7 +153,7 @@ void zoo_oop_label_cache_build(zoo_state *state, int16_t stat_id) {
 
 		// check existing stats
 		for (pos = 1; pos <= state->board.stat_count; pos++) {
-			if (state->board.stats[pos].data == stat->data && state->board.stats[pos].label_cache_size > 0) {
+			if (zoo_stat_data_bound(&state->board.stats[pos], stat) && state->board.stats[pos].label_cache_size > 0) {
 				stat->label_cache = state->board.stats[pos].label_cache;
 				stat->label_cache_size = state->board.stats[pos].label_cache_size;
 				return;
@@ -57,31 +161,25 @@ void zoo_oop_label_cache_build(zoo_state *state, int16_t stat_id) {
 		}
 
 		// count labels
-		for (pos = 0; pos < (stat->data_len-1); pos++) {
-			if (stat->data[pos] == '\r' && (stat->data[pos+1] == ':' || stat->data[pos+1] == '\'')) {
-				label_count++;
-				last_label_pos = pos;
-				pos++;
-			}
+		for (pos = zoo_oop_label_cache_next(stat, 0); pos >= 0; pos = zoo_oop_label_cache_next(stat, pos + 2)) {
+			label_count++;
 		}
 
 		// create cache
 		stat->label_cache_size = label_count + 1;
 		if (label_count > 0) {
-			stat->label_cache = malloc(sizeof(zoo_stat_label) * label_count);
+			stat->label_cache = malloc(zoo_oop_label_cache_bytes(label_count));
+			ZOO_METRICS_ADD(state, mallocs, 1);
 
-			pos = 0;
 			label_pos = 0;
-			for (pos = 0; pos <= last_label_pos; pos++) {
-				if (stat->data[pos] == '\r' && (stat->data[pos+1] == ':' || stat->data[pos+1] == '\'')) {
-					stat->label_cache[label_pos].pos = pos;
-					stat->label_cache[label_pos].zapped = stat->data[pos+1] == '\'';	
-					pos++;
-					label_pos++;
-				}
+			for (pos = zoo_oop_label_cache_next(stat, 0); pos >= 0; pos = zoo_oop_label_cache_next(stat, pos + 2)) {
+				stat->label_cache[label_pos].pos = pos;
+				stat->label_cache[label_pos].zapped = stat->data[pos+1] == '\'';
+				label_pos++;
 			}
 
 			// assert(label_pos == label_count);
+			zoo_oop_label_cache_index(stat);
 		}
 	} else {
 		stat->label_cache_size = 0;
@@ -112,14 +210,28 @@ int16_t zoo_oop_find_string_from(zoo_state *state, int16_t stat_id, const char *
 
 GBA_FAST_CODE
 int16_t zoo_oop_label_cache_search(zoo_state *state, int16_t stat_id, const char *object_message, bool zapped) {
+	zoo_stat *stat = &state->board.stats[stat_id];
 	int i;
 	int label_cache_size;
 	zoo_stat_label *label_cache;
 	int16_t pos;
+	uint16_t hash;
+	uint8_t len;
 
 	zoo_oop_label_cache_build(state, stat_id);
-	label_cache = state->board.stats[stat_id].label_cache;
-	label_cache_size = state->board.stats[stat_id].label_cache_size - 1;
+	label_cache = stat->label_cache;
+	label_cache_size = stat->label_cache_size - 1;
+	if (label_cache_size <= 0)
+		return -1;
+
+	if (zoo_oop_label_key(object_message, "", &hash, &len)) {
+		i = zoo_oop_label_cache_heads(stat)[hash & (zoo_oop_label_cache_buckets(label_cache_size) - 1)];
+		for (; i >= 0; i = label_cache[i].next) {
+			if (zapped == label_cache[i].zapped && zoo_oop_label_name_cmp(stat, &label_cache[i], object_message, hash, len))
+				return label_cache[i].pos;
+		}
+		return -1;
+	}
 
 	for (i = 0; i < label_cache_size; i++) {
 		// printf("id %d, entry %d: pos %d, %s\n", stat_id, i, label_cache[i].pos, label_cache[i].zapped ? "zapped" : "not zapped");
@@ -137,11 +249,15 @@ int16_t zoo_oop_label_cache_search(zoo_state *state, int16_t stat_id, const char
 	return -1;
 }
 
+// Flips a label, found by zoo_oop_label_cache_search. With recurse set,
+// also flips the labels after it which are followed by the same text.
 GBA_FAST_CODE
 void zoo_oop_label_cache_zap(zoo_state *state, int16_t stat_id, int16_t label_data_pos, bool zapped, bool recurse, const char *label) {
 	zoo_stat *stat = &state->board.stats[stat_id];
-	int ix;
+	int ix, lo, hi;
 	int16_t pos;
+	uint16_t hash;
+	uint8_t len;
 
 #ifdef ZOO_NO_OBJECT_CODE_WRITES
 	// Emulate #ZAP/RESTORE restart. (writes)
@@ -152,28 +268,58 @@ void zoo_oop_label_cache_zap(zoo_state *state, int16_t stat_id, int16_t label_da
 #endif
 
 	zoo_oop_label_cache_build(state, stat_id);
-	for (ix = 0; ix < stat->label_cache_size-1; ix++) {
-		if (stat->label_cache[ix].pos == label_data_pos) {
-			stat->label_cache[ix].zapped = zapped;
 #ifndef ZOO_NO_OBJECT_CODE_WRITES
-			stat->data[label_data_pos + 1] = zapped ? '\'' : ':';
+	zoo_stat_data_unshare(state, stat);
 #endif
-			break;
-		}
+
+	// labels are sorted by position
+	lo = 0;
+	hi = stat->label_cache_size - 1;
+	while (lo < hi) {
+		ix = (lo + hi) >> 1;
+		if (stat->label_cache[ix].pos < label_data_pos) lo = ix + 1;
+		else hi = ix;
 	}
+	ix = lo;
+	if (ix >= stat->label_cache_size - 1 || stat->label_cache[ix].pos != label_data_pos)
+		return;
+
+	stat->label_cache[ix].zapped = zapped;
+#ifndef ZOO_NO_OBJECT_CODE_WRITES
+	stat->data[label_data_pos + 1] = zapped ? '\'' : ':';
+#endif
 
 	if (recurse) {
 		// Find remaining positions
-		for (ix++; ix < stat->label_cache_size-1; ix++) {
-			if (stat->label_cache[ix].zapped != zapped) {
-				pos = stat->label_cache[ix].pos;
-				if (zoo_oop_find_string_from(state, stat_id, label, pos + 2, pos + 2) >= 0) {
+		if (zoo_oop_label_key(label, "\r", &hash, &len)) {
+			// the name must be followed by the line end, and the line after
+			// it must not start with a name character
+			ix = zoo_oop_label_cache_heads(stat)[hash & (zoo_oop_label_cache_buckets(stat->label_cache_size - 1) - 1)];
+			for (; ix >= 0; ix = stat->label_cache[ix].next) {
+				pos = stat->label_cache[ix].pos + 2 + len;
+				if (stat->label_cache[ix].pos > label_data_pos
+					&& stat->label_cache[ix].zapped != zapped
+					&& zoo_oop_label_name_cmp(stat, &stat->label_cache[ix], label, hash, len)
+					&& pos < stat->data_len && stat->data[pos] == '\r'
+					&& !(pos + 1 < stat->data_len && zoo_oop_label_char(stat->data[pos + 1]))) {
 					stat->label_cache[ix].zapped = zapped;
 #ifndef ZOO_NO_OBJECT_CODE_WRITES
 					stat->data[stat->label_cache[ix].pos + 1] = zapped ? '\'' : ':';
 #endif
 				}
 			}
+		} else {
+			for (ix++; ix < stat->label_cache_size-1; ix++) {
+				if (stat->label_cache[ix].zapped != zapped) {
+					pos = stat->label_cache[ix].pos;
+					if (zoo_oop_find_string_from(state, stat_id, label, pos + 2, pos + 2) >= 0) {
+						stat->label_cache[ix].zapped = zapped;
+#ifndef ZOO_NO_OBJECT_CODE_WRITES
+						stat->data[stat->label_cache[ix].pos + 1] = zapped ? '\'' : ':';
+#endif
+					}
+				}
+			}
 		}
 	}
 }
@@ -0,0 +1,247 @@
+/**
+ * Copyright (c) 2020 Adrian Siekierka
+ *
+ * Based on a reconstruction of code from ZZT,
+ * Copyright 1991 Epic MegaGames, used with permission.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "zoo_internal.h"
+
+/**
+ * Tick profiler.
+ * Counts calls to, and time spent in, the element functions libzoo
+ * dispatches itself - from zoo_game_tick, the call stack and board drawing -
+ * by element and by stat, along with the OOP commands run by instruction.
+ *
+ * Time spent in nested calls (a stat touching another tile, say) is counted
+ * toward both the inner and the outer call.
+ */
+
+static uint32_t zoo_profile_clock(void) {
+	return (uint32_t) clock();
+}
+
+bool zoo_profile_enable(zoo_state *state, uint32_t (*func_time)(void), const char *time_unit) {
+	if (state->profile == NULL) {
+		state->profile = malloc(sizeof(zoo_profile));
+		if (state->profile == NULL)
+			return false;
+	}
+
+	if (func_time == NULL) {
+		state->profile->func_time = zoo_profile_clock;
+		state->profile->time_unit = "clock";
+	} else {
+		state->profile->func_time = func_time;
+		state->profile->time_unit = time_unit != NULL ? time_unit : "";
+	}
+	zoo_profile_reset(state);
+	return true;
+}
+
+void zoo_profile_disable(zoo_state *state) {
+	if (state->profile != NULL) {
+		free(state->profile);
+		state->profile = NULL;
+	}
+}
+
+void zoo_profile_reset(zoo_state *state) {
+	zoo_profile *profile = state->profile;
+
+	if (profile == NULL)
+		return;
+	memset(profile->element_tick, 0, sizeof(profile->element_tick));
+	memset(profile->element_touch, 0, sizeof(profile->element_touch));
+	memset(profile->element_draw, 0, sizeof(profile->element_draw));
+	memset(profile->stat_tick, 0, sizeof(profile->stat_tick));
+	memset(profile->oop_commands, 0, sizeof(profile->oop_commands));
+	profile->stat_board = state->world.info.current_board;
+}
+
+void zoo_profile_record(zoo_state *state, zoo_profile *profile, zoo_profile_counter *counters, uint8_t element, int16_t stat_id, uint32_t start) {
+	uint32_t time = profile->func_time() - start;
+
+	counters[element].calls++;
+	counters[element].time += time;
+
+	if (stat_id >= 0 && stat_id < (ZOO_MAX_STAT + 2)) {
+		// stat IDs only mean anything within one board
+		if (profile->stat_board != state->world.info.current_board) {
+			memset(profile->stat_tick, 0, sizeof(profile->stat_tick));
+			profile->stat_board = state->world.info.current_board;
+		}
+		profile->stat_tick[stat_id].calls++;
+		profile->stat_tick[stat_id].time += time;
+	}
+}
+
+// output
+
+static void zoo_profile_puts(zoo_io_handle *h, const char *str) {
+	h->func_write(h, (const uint8_t *) str, strlen(str));
+}
+
+static void zoo_profile_putu(zoo_io_handle *h, uint64_t value) {
+	char buf[21];
+	int i = sizeof(buf) - 1;
+
+	buf[i] = '\0';
+	do {
+		buf[--i] = '0' + (value % 10);
+		value /= 10;
+	} while (value > 0);
+	zoo_profile_puts(h, buf + i);
+}
+
+// names are written quoted; anything that isn't printable ASCII, or would
+// need escaping, is replaced
+static void zoo_profile_putname(zoo_io_handle *h, const char *name) {
+	char buf[64];
+	int i;
+
+	buf[0] = '"';
+	for (i = 1; *name != '\0' && i < (int) sizeof(buf) - 2; name++, i++) {
+		buf[i] = (*name >= 32 && *name < 127 && *name != '"' && *name != '\\') ? *name : '?';
+	}
+	buf[i++] = '"';
+	buf[i] = '\0';
+	zoo_profile_puts(h, buf);
+}
+
+static const char *zoo_profile_oop_name(uint8_t token) {
+	return token == 255 ? "(label)" : zoo_oop_token_name(token);
+}
+
+static void zoo_profile_json_counter(zoo_io_handle *h, const char *key, zoo_profile_counter *counter) {
+	zoo_profile_puts(h, ", \"");
+	zoo_profile_puts(h, key);
+	zoo_profile_puts(h, "\": {\"calls\": ");
+	zoo_profile_putu(h, counter->calls);
+	zoo_profile_puts(h, ", \"time\": ");
+	zoo_profile_putu(h, counter->time);
+	zoo_profile_puts(h, "}");
+}
+
+static void zoo_profile_write_json(zoo_profile *profile, zoo_io_handle *h) {
+	bool first;
+	int i;
+
+	zoo_profile_puts(h, "{\n\t\"time_unit\": ");
+	zoo_profile_putname(h, profile->time_unit);
+	zoo_profile_puts(h, ",\n\t\"elements\": [");
+	first = true;
+	for (i = 0; i <= ZOO_MAX_ELEMENT; i++) {
+		if (profile->element_tick[i].calls == 0 && profile->element_touch[i].calls == 0
+			&& profile->element_draw[i].calls == 0)
+			continue;
+		zoo_profile_puts(h, first ? "\n\t\t{\"id\": " : ",\n\t\t{\"id\": ");
+		zoo_profile_putu(h, i);
+		zoo_profile_puts(h, ", \"name\": ");
+		zoo_profile_putname(h, zoo_element_defs[i].name);
+		zoo_profile_json_counter(h, "tick", &profile->element_tick[i]);
+		zoo_profile_json_counter(h, "touch", &profile->element_touch[i]);
+		zoo_profile_json_counter(h, "draw", &profile->element_draw[i]);
+		zoo_profile_puts(h, "}");
+		first = false;
+	}
+	zoo_profile_puts(h, "\n\t],\n\t\"stats_board\": ");
+	zoo_profile_putu(h, profile->stat_board < 0 ? 0 : profile->stat_board);
+	zoo_profile_puts(h, ",\n\t\"stats\": [");
+	first = true;
+	for (i = 0; i < (ZOO_MAX_STAT + 2); i++) {
+		if (profile->stat_tick[i].calls == 0)
+			continue;
+		zoo_profile_puts(h, first ? "\n\t\t{\"id\": " : ",\n\t\t{\"id\": ");
+		zoo_profile_putu(h, i);
+		zoo_profile_json_counter(h, "tick", &profile->stat_tick[i]);
+		zoo_profile_puts(h, "}");
+		first = false;
+	}
+	zoo_profile_puts(h, "\n\t],\n\t\"oop_commands\": [");
+	first = true;
+	for (i = 0; i < 256; i++) {
+		if (profile->oop_commands[i] == 0)
+			continue;
+		zoo_profile_puts(h, first ? "\n\t\t{\"command\": " : ",\n\t\t{\"command\": ");
+		zoo_profile_putname(h, zoo_profile_oop_name(i));
+		zoo_profile_puts(h, ", \"count\": ");
+		zoo_profile_putu(h, profile->oop_commands[i]);
+		zoo_profile_puts(h, "}");
+		first = false;
+	}
+	zoo_profile_puts(h, "\n\t]\n}\n");
+}
+
+static void zoo_profile_csv_counter(zoo_io_handle *h, const char *kind, int id, const char *name, zoo_profile_counter *counter) {
+	if (counter->calls == 0)
+		return;
+	zoo_profile_puts(h, kind);
+	zoo_profile_puts(h, ",");
+	zoo_profile_putu(h, id);
+	zoo_profile_puts(h, ",");
+	zoo_profile_putname(h, name);
+	zoo_profile_puts(h, ",");
+	zoo_profile_putu(h, counter->calls);
+	zoo_profile_puts(h, ",");
+	zoo_profile_putu(h, counter->time);
+	zoo_profile_puts(h, "\n");
+}
+
+static void zoo_profile_write_csv(zoo_profile *profile, zoo_io_handle *h) {
+	zoo_profile_counter counter;
+	int i;
+
+	zoo_profile_puts(h, "kind,id,name,calls,time\n");
+	for (i = 0; i <= ZOO_MAX_ELEMENT; i++) {
+		zoo_profile_csv_counter(h, "tick", i, zoo_element_defs[i].name, &profile->element_tick[i]);
+		zoo_profile_csv_counter(h, "touch", i, zoo_element_defs[i].name, &profile->element_touch[i]);
+		zoo_profile_csv_counter(h, "draw", i, zoo_element_defs[i].name, &profile->element_draw[i]);
+	}
+	for (i = 0; i < (ZOO_MAX_STAT + 2); i++) {
+		zoo_profile_csv_counter(h, "stat", i, "", &profile->stat_tick[i]);
+	}
+	// OOP commands are counted, not timed
+	counter.time = 0;
+	for (i = 0; i < 256; i++) {
+		counter.calls = profile->oop_commands[i];
+		zoo_profile_csv_counter(h, "oop", i, zoo_profile_oop_name(i), &counter);
+	}
+}
+
+int zoo_profile_write(zoo_state *state, zoo_io_handle *h, zoo_profile_format format) {
+	if (state->profile == NULL)
+		return ZOO_ERROR_INVAL;
+
+	switch (format) {
+		case ZOO_PROFILE_JSON:
+			zoo_profile_write_json(state->profile, h);
+			return 0;
+		case ZOO_PROFILE_CSV:
+			zoo_profile_write_csv(state->profile, h);
+			return 0;
+		default:
+			return ZOO_ERROR_INVAL;
+	}
+}
@@ -104,6 +104,9 @@ void zoo_sound_queue(zoo_sound_state *state, int16_t priority, const uint8_t *da
 			}
 		}
 		state->is_playing = true;
+#ifdef ZOO_METRICS
+		state->metrics_notes += len >> 1;
+#endif
 	}
 }
 
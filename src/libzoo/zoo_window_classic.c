@@ -33,30 +33,25 @@
 #define WINDOW_STATE_TICK 2
 #define WINDOW_STATE_ANIM_CLOSE 3
 
-static int16_t window_x = 5;
-static int16_t window_y = 3;
-static int16_t window_width = 49;
-static int16_t window_height = 19;
-
-#define WINDOW_ANIM_MAX (window_height >> 1)
-
-void zoo_window_set_position(int16_t x, int16_t y, int16_t width, int16_t height) {
-	window_x = x;
-	window_y = y;
-	window_width = width;
-	window_height = height;
+#define WINDOW_ANIM_MAX (state->window_height >> 1)
+
+void zoo_window_set_position(zoo_state *state, int16_t x, int16_t y, int16_t width, int16_t height) {
+	state->window_x = x;
+	state->window_y = y;
+	state->window_width = width;
+	state->window_height = height;
 }
 
 static void zoo_window_draw_title(zoo_text_window *window, zoo_state *state, uint8_t color, const char *title) {
 	int16_t i;
 	int16_t il = strlen(title);
-	int16_t is = window_x + ((window_width + 1 - il) >> 1);
+	int16_t is = state->window_x + ((state->window_width + 1 - il) >> 1);
 
-	for (i = window_x + 2; i < (window_x + window_width - 2); i++) {
+	for (i = state->window_x + 2; i < (state->window_x + state->window_width - 2); i++) {
 		if (i >= is && i < (is+il)) {
-			state->d_video->func_write(state->d_video, i, window_y + 1, color, title[i - is]);
+			state->d_video->func_write(state->d_video, i, state->window_y + 1, color, title[i - is]);
 		} else {
-			state->d_video->func_write(state->d_video, i, window_y + 1, color, ' ');
+			state->d_video->func_write(state->d_video, i, state->window_y + 1, color, ' ');
 		}
 	}
 }
@@ -83,15 +78,15 @@ void zoo_window_draw_pattern(zoo_state *state, int16_t x, int16_t y, int16_t wid
 }
 
 static ZOO_INLINE void zoo_window_draw_border(zoo_text_window *window, zoo_state *state, int16_t y, zoo_window_pattern_type ptype) {
-	zoo_window_draw_pattern(state, window_x, y, window_width, 0x0F, ptype);
+	zoo_window_draw_pattern(state, state->window_x, y, state->window_width, 0x0F, ptype);
 }
 
 static void zoo_window_draw_open(zoo_text_window *window, zoo_state *state) {
 	int16_t ix;
-	int16_t y0 = window_y + window->counter;
-	int16_t y1 = window_y + window->counter + 1;
-	int16_t y2 = window_y + window_height - window->counter - 2;
-	int16_t y3 = window_y + window_height - window->counter - 1;
+	int16_t y0 = state->window_y + window->counter;
+	int16_t y1 = state->window_y + window->counter + 1;
+	int16_t y2 = state->window_y + state->window_height - window->counter - 2;
+	int16_t y3 = state->window_y + state->window_height - window->counter - 1;
 
 	zoo_window_draw_border(window, state, y0, ZOO_WINDOW_PATTERN_TOP);
 	zoo_window_draw_border(window, state, y1, ZOO_WINDOW_PATTERN_INNER);
@@ -100,18 +95,18 @@ static void zoo_window_draw_open(zoo_text_window *window, zoo_state *state) {
 }
 
 static void zoo_window_draw_open_finish(zoo_text_window *window, zoo_state *state) {
-	zoo_window_draw_border(window, state, window_y + 2, ZOO_WINDOW_PATTERN_SEPARATOR);
+	zoo_window_draw_border(window, state, state->window_y + 2, ZOO_WINDOW_PATTERN_SEPARATOR);
 	zoo_window_draw_title(window, state, 0x1E, window->title);
 }
 
 static void zoo_window_draw_open_all(zoo_text_window *window, zoo_state *state) {
 	int16_t iy;
 
-	zoo_window_draw_border(window, state, window_y, ZOO_WINDOW_PATTERN_TOP);
-	for (iy = 1; iy < window_height - 1; iy++) {
-		zoo_window_draw_border(window, state, window_y + iy, iy == 2 ? ZOO_WINDOW_PATTERN_SEPARATOR : ZOO_WINDOW_PATTERN_INNER);	
+	zoo_window_draw_border(window, state, state->window_y, ZOO_WINDOW_PATTERN_TOP);
+	for (iy = 1; iy < state->window_height - 1; iy++) {
+		zoo_window_draw_border(window, state, state->window_y + iy, iy == 2 ? ZOO_WINDOW_PATTERN_SEPARATOR : ZOO_WINDOW_PATTERN_INNER);	
 	}
-	zoo_window_draw_border(window, state, window_y + window_height - 1, ZOO_WINDOW_PATTERN_BOTTOM);
+	zoo_window_draw_border(window, state, state->window_y + state->window_height - 1, ZOO_WINDOW_PATTERN_BOTTOM);
 }
 
 static void zoo_window_draw_line(zoo_text_window *window, zoo_state *state, int16_t line_pos, bool no_formatting) {
@@ -124,15 +119,15 @@ static void zoo_window_draw_line(zoo_text_window *window, zoo_state *state, int1
 	char *str = NULL;
 	char *tmp = NULL;
 
-	line_y = (window_y + line_pos - window->line_pos) + (window_height >> 1) + 1;
+	line_y = (state->window_y + line_pos - window->line_pos) + (state->window_height >> 1) + 1;
 	same_line = line_pos == window->line_pos;
-	state->d_video->func_write(state->d_video, window_x + 2, line_y, 0x1C, same_line ? '\xAF' : ' ');
-	state->d_video->func_write(state->d_video, window_x + window_width - 3, line_y, 0x1C, same_line ? '\xAE' : ' ');
+	state->d_video->func_write(state->d_video, state->window_x + 2, line_y, 0x1C, same_line ? '\xAF' : ' ');
+	state->d_video->func_write(state->d_video, state->window_x + state->window_width - 3, line_y, 0x1C, same_line ? '\xAE' : ' ');
 
 	text_offset = 0;
 	text_color = 0x1E;
 	text_x = 0;
-	text_width = (window_width - 7);
+	text_width = (state->window_width - 7);
 
 	str = zoo_window_line_at(window, line_pos);
 	if (str != NULL) {
@@ -163,16 +158,16 @@ static void zoo_window_draw_line(zoo_text_window *window, zoo_state *state, int1
 	if (str != NULL) {
 		for (i = -text_x - 1; i < (text_width - text_x); i++) {
 			if (draw_arrow && i == -3) {
- 				state->d_video->func_write(state->d_video, window_x + 4 + i + text_x, line_y, 0x1D, '\x10');
+ 				state->d_video->func_write(state->d_video, state->window_x + 4 + i + text_x, line_y, 0x1D, '\x10');
 			} else {
-				state->d_video->func_write(state->d_video, window_x + 4 + i + text_x, line_y, text_color,
+				state->d_video->func_write(state->d_video, state->window_x + 4 + i + text_x, line_y, text_color,
 					(i >= 0 && i < strlen(str)) ? str[i] : ' ');
 			}
 		}
 	} else {
 		is_boundary = line_pos == -1 || line_pos == window->line_count;
-		for (i = 0; i < (window_width - 4); i++) {
-			state->d_video->func_write(state->d_video, window_x + 2 + i, line_y, text_color,
+		for (i = 0; i < (state->window_width - 4); i++) {
+			state->d_video->func_write(state->d_video, state->window_x + 2 + i, line_y, text_color,
 				(is_boundary && ((i % 5) == 4)) ? '\x07' : ' ');
 		}
 	}
@@ -181,8 +176,8 @@ static void zoo_window_draw_line(zoo_text_window *window, zoo_state *state, int1
 
 static void zoo_window_draw_text(zoo_text_window *window, zoo_state *state, bool no_formatting) {
 	int i;
-	for (i = 0; i < window_height - 4; i++) {
-		zoo_window_draw_line(window, state, window->line_pos - (window_height >> 1) + i + 2, no_formatting);
+	for (i = 0; i < state->window_height - 4; i++) {
+		zoo_window_draw_line(window, state, window->line_pos - (state->window_height >> 1) + i + 2, no_formatting);
 	}
 	zoo_window_draw_title(window, state, 0x1E, window->title);
 }
@@ -194,8 +189,8 @@ static void zoo_window_draw_close(zoo_text_window *window, zoo_state *state) {
 	// draw line at counter + 1
 	iy = window->counter + 1;
 	if (iy <= WINDOW_ANIM_MAX) {
-		y0 = window_y + iy;
-		y1 = window_y + window_height - iy - 1;
+		y0 = state->window_y + iy;
+		y1 = state->window_y + state->window_height - iy - 1;
 
 		zoo_window_draw_border(window, state, y0, ZOO_WINDOW_PATTERN_TOP);
 		zoo_window_draw_border(window, state, y1, ZOO_WINDOW_PATTERN_BOTTOM);
@@ -203,10 +198,10 @@ static void zoo_window_draw_close(zoo_text_window *window, zoo_state *state) {
 
 	// restore line at counter
 	iy = window->counter;
-	zoo_restore_display(state, window->screen_copy, window_width, window_height,
-		0, iy, window_width, 1, window_x, window_y + iy);
-	zoo_restore_display(state, window->screen_copy, window_width, window_height,
-		0, window_height - iy - 1, window_width, 1, window_x, window_y + window_height - iy - 1);
+	zoo_restore_display(state, window->screen_copy, state->window_width, state->window_height,
+		0, iy, state->window_width, 1, state->window_x, state->window_y + iy);
+	zoo_restore_display(state, window->screen_copy, state->window_width, state->window_height,
+		0, state->window_height - iy - 1, state->window_width, 1, state->window_x, state->window_y + state->window_height - iy - 1);
 }
 
 // if TRUE, close the window
@@ -251,7 +246,7 @@ static zoo_tick_retval zoo_window_classic_tick(zoo_state *state, zoo_text_window
 
 	switch (window->state) {
 		case WINDOW_STATE_START:
-			window->screen_copy = zoo_store_display(state, window_x, window_y, window_width, window_height);
+			window->screen_copy = zoo_store_display(state, state->window_x, state->window_y, state->window_width, state->window_height);
 			window->counter = WINDOW_ANIM_MAX;
 			window->state = WINDOW_STATE_ANIM_OPEN;
 			if (window->disable_transitions) {
@@ -293,7 +288,7 @@ static zoo_tick_retval zoo_window_classic_tick(zoo_state *state, zoo_text_window
 				window->state = WINDOW_STATE_ANIM_CLOSE;
 				window->accepted = act_ok;
 				if (window->disable_transitions) {
-					zoo_restore_display(state, window->screen_copy, window_width, window_height, 0, 0, window_width, window_height, window_x, window_y);
+					zoo_restore_display(state, window->screen_copy, state->window_width, state->window_height, 0, 0, state->window_width, state->window_height, state->window_x, state->window_y);
 					goto CloseWindow;
 				} else {
 					window->counter = 0;
@@ -318,7 +313,7 @@ static zoo_tick_retval zoo_window_classic_tick(zoo_state *state, zoo_text_window
 					}
 					return EXIT;
 				} else {
-					zoo_restore_display(state, window->screen_copy, window_width, window_height, 0, 0, window_width, window_height, window_x, window_y);
+					zoo_restore_display(state, window->screen_copy, state->window_width, state->window_height, 0, 0, state->window_width, state->window_height, state->window_x, state->window_y);
 					zoo_free_display(state, window->screen_copy);
 					window->state = WINDOW_STATE_START;
 					zoo_input_clear(&state->input);
@@ -7,9 +7,8 @@
 extern int platform_debug_free_memory(void);
 extern void platform_debug_puts(const char *str, bool status);
 
-static char debug_buffer[80 + 1];
-
 void zoo_ui_debug_printf(bool status, const char *format, ...) {
+    char debug_buffer[80 + 1];
     va_list args;
     va_start(args, format);
     vsniprintf(debug_buffer, sizeof(debug_buffer), format, args);
@@ -41,6 +40,34 @@ static ZOO_INLINE void zoo_ui_dbg_memtest(zoo_state *zoo) {
 	zoo_board_open(zoo, curr_board);
 }
 
+static ZOO_INLINE void zoo_ui_dbg_oopstats(zoo_state *zoo) {
+	int i;
+
+	zoo_ui_debug_printf(false, "oop limit hits = %lu, frame yields = %lu\n",
+		(unsigned long) zoo->oop_limit_hits, (unsigned long) zoo->oop_frame_yields);
+	for (i = 1; i <= zoo->board.stat_count; i++) {
+		if (zoo->board.stats[i].oop_limit_hits > 0) {
+			zoo_ui_debug_printf(false, "stat %d (%d, %d): %u limit hits\n", i,
+				zoo->board.stats[i].x, zoo->board.stats[i].y, zoo->board.stats[i].oop_limit_hits);
+		}
+	}
+}
+
+#ifdef ZOO_PROFILE
+static void zoo_ui_dbg_profile_save(zoo_state *zoo, const char *filename, zoo_profile_format format) {
+	zoo_io_handle h;
+
+	h = zoo->d_io->func_open_file(zoo->d_io, filename, MODE_WRITE);
+	if (zoo_io_file_is_empty(&h)) {
+		zoo_ui_debug_printf(false, "could not open %s\n", filename);
+		return;
+	}
+	zoo_profile_write(zoo, &h, format);
+	h.func_close(&h);
+	zoo_ui_debug_printf(false, "profile saved to %s\n", filename);
+}
+#endif
+
 static zoo_tick_retval zoo_ui_debug_menu_cb(zoo_state *zoo, zoo_ui_state *cb_state) {
 	char hyperlink[21];
 	strncpy(hyperlink, cb_state->window.hyperlink, sizeof(hyperlink));
@@ -52,6 +79,19 @@ static zoo_tick_retval zoo_ui_debug_menu_cb(zoo_state *zoo, zoo_ui_state *cb_sta
 		zoo_ui_dbg_memfree(zoo);
 	} else if (!strcmp(hyperlink, "bmemtest")) {
 		zoo_ui_dbg_memtest(zoo);
+	} else if (!strcmp(hyperlink, "oopstats")) {
+		zoo_ui_dbg_oopstats(zoo);
+#ifdef ZOO_PROFILE
+	} else if (!strcmp(hyperlink, "profon")) {
+		if (!zoo_profile_enable(zoo, NULL, NULL)) {
+			zoo_ui_debug_printf(false, "could not allocate profile\n");
+		}
+	} else if (!strcmp(hyperlink, "profsave")) {
+		zoo_ui_dbg_profile_save(zoo, "PROFILE.JSN", ZOO_PROFILE_JSON);
+		zoo_ui_dbg_profile_save(zoo, "PROFILE.CSV", ZOO_PROFILE_CSV);
+	} else if (!strcmp(hyperlink, "profoff")) {
+		zoo_profile_disable(zoo);
+#endif
 	}
 
 	return RETURN_IMMEDIATE;
@@ -63,7 +103,16 @@ void zoo_ui_debug_menu(struct s_zoo_ui_state *state) {
 	zoo_window_append(&state->window, "!memfree;Print free memory");
 	if (state->zoo->game_state == GS_PLAY && !state->zoo->game_paused) {
 		zoo_window_append(&state->window, "!bmemtest;Test board memory usage");
+		zoo_window_append(&state->window, "!oopstats;Show objects over the OOP limit");
+	}
+#ifdef ZOO_PROFILE
+	if (state->zoo->profile == NULL) {
+		zoo_window_append(&state->window, "!profon;Start tick profiling");
+	} else {
+		zoo_window_append(&state->window, "!profsave;Save tick profile");
+		zoo_window_append(&state->window, "!profoff;Stop tick profiling");
 	}
+#endif
 
 	zoo_call_push_callback(&(state->zoo->call_stack), (zoo_func_callback) zoo_ui_debug_menu_cb, state);
 	zoo_window_open(state->zoo, &state->window);
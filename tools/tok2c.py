@@ -8,10 +8,40 @@ import sys
 
 toksets = {}
 
+def tok_hash(word, mul):
+	value = 0
+	for c in word.encode("ascii"):
+		value = (value * mul + c) & 0xFFFFFFFF
+	return value
+
+# Finds a multiplier and shift for which every word in the token set lands
+# in a distinct slot of the smallest possible power-of-two table. The table
+# mask is stored as a uint8_t, so tables are limited to 256 slots.
+MAX_TABLE_SIZE = 256
+# Only small odd multipliers are tried before doubling the table: a table
+# that is too full rarely works out further on, and proving so over every
+# 16-bit multiplier made each regeneration take seconds.
+MAX_MUL = 256
+
+def find_perfect_hash(words):
+	size = 1
+	while size < len(words):
+		size *= 2
+	while size <= MAX_TABLE_SIZE:
+		for mul in range(1, MAX_MUL, 2):
+			hashes = [tok_hash(word, mul) for word in words]
+			for shift in range(0, 16):
+				slots = set((value >> shift) & (size - 1) for value in hashes)
+				if len(slots) == len(words):
+					return size, mul, shift
+		size *= 2
+	sys.exit("tok2c.py: no perfect hash for %d words fits in %d slots" % (len(words), MAX_TABLE_SIZE))
+
 def main(args):
 	script_dir = Path(__file__).resolve().parent
 	stem = Path(args.i).stem
 	struct_type = "tok_entry_%s" % stem
+	table_type = "tok_table_%s" % stem
 	token_type = "uint8_t"
 
 	with open(args.i, "r") as f:
@@ -42,20 +72,29 @@ def main(args):
 			f.write("#define TOK_%s_INVALID %d\n" % (tokset_name, 255))
 			f.write("\n")
 		# generate struct def
-		f.write("typedef struct { const char *word; %s id; } %s;\n\n" % (token_type, struct_type));
+		f.write("typedef struct { const char *word; %s id; } %s;\n" % (token_type, struct_type));
+		f.write("typedef struct { uint32_t mul; uint8_t shift; uint8_t mask; const %s *entries; } %s;\n\n" % (struct_type, table_type));
 		# generate structs
 		for tokset_name, tokset in toksets.items():
 			tokset_struct_name = "tok_%s_%s" % (stem, tokset_name.lower())
-			f.write("static const %s %s[] = {\n" % (struct_type, tokset_struct_name))
-			for tokset_entry_name, tokset_entry in sorted(tokset.items()):
-				f.write("\t{\"%s\", %d},\n" % (tokset_entry_name, tokset_entry['id']))
-			f.write("\t{\"\", TOK_%s_INVALID}\n" % (tokset_name))
+			size, mul, shift = find_perfect_hash(tokset.keys())
+			slots = [None] * size
+			for tokset_entry_name, tokset_entry in tokset.items():
+				slots[(tok_hash(tokset_entry_name, mul) >> shift) & (size - 1)] = (tokset_entry_name, tokset_entry['id'])
+			f.write("static const %s %s_entries[%d] = {\n" % (struct_type, tokset_struct_name, size))
+			for slot in slots:
+				if slot is None:
+					f.write("\t{\"\", TOK_%s_INVALID},\n" % (tokset_name))
+				else:
+					f.write("\t{\"%s\", %d},\n" % slot)
 			f.write("};\n\n")
+			f.write("static const %s %s = {%d, %d, %d, %s_entries};\n\n" % (table_type, tokset_struct_name, mul, shift, size - 1, tokset_struct_name))
 		# copy code
 		with open(script_dir.joinpath("tok2c_tpl.c")) as ff:
 			tpl_code = ff.read()
 			tpl_code = tpl_code.replace("%STEM%", stem)
 			tpl_code = tpl_code.replace("%STRUCT_TYPE%", struct_type)
+			tpl_code = tpl_code.replace("%TABLE_TYPE%", table_type)
 			tpl_code = tpl_code.replace("%TOKEN_TYPE%", token_type)
 			f.write(tpl_code)
 
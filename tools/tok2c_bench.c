@@ -0,0 +1,113 @@
+// Compares the perfect hash lookup generated by tok2c.py against the linear
+// search it replaced, over every token of zoo_oop_token.tok plus a few words
+// which are not tokens (label names, element names, typos).
+//
+// python3 tools/tok2c.py src/libzoo/zoo_oop_token.tok /tmp/zoo_oop_token.c
+// cc -O2 -I/tmp tools/tok2c_bench.c -o /tmp/tok2c_bench && /tmp/tok2c_bench
+
+#include <stdio.h>
+#include <time.h>
+#include "zoo_oop_token.c"
+
+#define ROUNDS 200000
+#define MAX_WORDS 64
+
+static const char *misses[] = {
+	"TOUCH", "SHOT", "ENERGIZE", "THUD", "PLAYER", "GEM", "AMMO",
+	"TORCHES", "SCORE", "GOTO", "N", "RESTARTS", "X", "LOOP"
+};
+
+static const tok_table_zoo_oop_token *tables[] = {
+	&tok_zoo_oop_token_ins,
+	&tok_zoo_oop_token_give,
+	&tok_zoo_oop_token_cond,
+	&tok_zoo_oop_token_dir,
+	&tok_zoo_oop_token_color
+};
+
+#define TABLE_COUNT ((int) (sizeof(tables) / sizeof(tables[0])))
+#define MISS_COUNT ((int) (sizeof(misses) / sizeof(misses[0])))
+
+// the table layout tok2c.py used to emit: sorted, ended by an empty word
+static tok_entry_zoo_oop_token linear[TABLE_COUNT][MAX_WORDS + 1];
+static const char *words[TABLE_COUNT][MAX_WORDS + MISS_COUNT];
+static int word_count[TABLE_COUNT];
+
+static uint8_t linear_search(const tok_entry_zoo_oop_token *table, const char *tok) {
+	while (table->word[0] != '\0') {
+		if (table->word[0] == tok[0]) {
+			if (!strcmp(tok + 1, table->word + 1)) {
+				return table->id;
+			}
+		}
+		table++;
+	}
+	return 255;
+}
+
+static int entry_cmp(const void *a, const void *b) {
+	return strcmp(((const tok_entry_zoo_oop_token *) a)->word, ((const tok_entry_zoo_oop_token *) b)->word);
+}
+
+static void build_tables(void) {
+	int t, i, n;
+
+	for (t = 0; t < TABLE_COUNT; t++) {
+		n = 0;
+		for (i = 0; i <= tables[t]->mask; i++) {
+			if (tables[t]->entries[i].word[0] != '\0') {
+				linear[t][n] = tables[t]->entries[i];
+				words[t][n++] = tables[t]->entries[i].word;
+			}
+		}
+		qsort(linear[t], n, sizeof(tok_entry_zoo_oop_token), entry_cmp);
+		linear[t][n].word = "";
+		linear[t][n].id = 255;
+		for (i = 0; i < MISS_COUNT; i++) {
+			words[t][n++] = misses[i];
+		}
+		word_count[t] = n;
+	}
+}
+
+int main(void) {
+	volatile uint32_t sink = 0;
+	clock_t start;
+	double linear_time, hash_time;
+	int r, t, i;
+
+	build_tables();
+
+	for (t = 0; t < TABLE_COUNT; t++) {
+		for (i = 0; i < word_count[t]; i++) {
+			if (zoo_oop_token_search(tables[t], words[t][i]) != linear_search(linear[t], words[t][i])) {
+				fprintf(stderr, "mismatch on %s\n", words[t][i]);
+				return 1;
+			}
+		}
+	}
+
+	start = clock();
+	for (r = 0; r < ROUNDS; r++) {
+		for (t = 0; t < TABLE_COUNT; t++) {
+			for (i = 0; i < word_count[t]; i++) {
+				sink += linear_search(linear[t], words[t][i]);
+			}
+		}
+	}
+	linear_time = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+	start = clock();
+	for (r = 0; r < ROUNDS; r++) {
+		for (t = 0; t < TABLE_COUNT; t++) {
+			for (i = 0; i < word_count[t]; i++) {
+				sink += zoo_oop_token_search(tables[t], words[t][i]);
+			}
+		}
+	}
+	hash_time = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+	printf("linear search: %.3f s\n", linear_time);
+	printf("perfect hash:  %.3f s (%.2fx)\n", hash_time, linear_time / hash_time);
+	return 0;
+}
@@ -1,12 +1,16 @@
-static %TOKEN_TYPE% %STEM%_search(const %STRUCT_TYPE% *table, const char *tok) {
-	// TODO: optimize this
-	while (table->word[0] != '\0') {
-		if (table->word[0] == tok[0]) {
-			if (!strcmp(tok + 1, table->word + 1)) {
-				return table->id;
-			}
-		}
-		table++;
+static %TOKEN_TYPE% %STEM%_search(const %TABLE_TYPE% *table, const char *tok) {
+	// The table is a perfect hash of its tokens: a token can only be found
+	// in the one slot its hash points to.
+	const %STRUCT_TYPE% *entry;
+	const char *c;
+	uint32_t hash = 0;
+
+	for (c = tok; *c != '\0'; c++) {
+		hash = hash * table->mul + (uint8_t) *c;
+	}
+	entry = &table->entries[(hash >> table->shift) & table->mask];
+	if (entry->word[0] == tok[0] && !strcmp(tok, entry->word)) {
+		return entry->id;
 	}
 	return 255;
 }